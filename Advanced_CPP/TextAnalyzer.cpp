@@ -1,251 +1,3572 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <map>
 #include <vector>
 #include <algorithm>
 #include <cctype>
-#include <sstream>
 #include <iomanip>
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+#include <string_view>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <filesystem>
+#include <array>
+#include <random>
+#include <sstream>
 
-class TextAnalyzer {
+#if defined(__unix__) || defined(__APPLE__)
+#define TEXT_ANALYZER_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Same whitespace set that operator>> uses in the "C" locale
+inline bool isSpaceByte(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Read-only memory mapping of a whole file (a plain copy where mmap is missing)
+class MappedFile {
 private:
-    std::string text;
-    std::map<std::string, int> wordFrequency;
-    int totalWords;
-    int totalSentences;
-    int totalSyllables;
+    const char* ptr = nullptr;
+    size_t length = 0;
+#ifndef TEXT_ANALYZER_HAS_MMAP
+    std::vector<char> copy; // Without mmap the file is read into memory instead
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& filename);
+    void close();
+
+    // Tell the kernel it may drop the pages of an already processed range
+    void release(size_t offset, size_t bytes);
+
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+};
+
+// Bump allocator that interns word bytes in large blocks. Strings are never
+// freed one by one; the whole arena is dropped at once.
+class StringArena {
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+
+public:
+    const char* intern(std::string_view bytes);
+    void clear();
+};
+
+const char* StringArena::intern(std::string_view bytes) {
+    if (bytes.size() > remaining) {
+        // Oversized words get a block of their own
+        size_t blockSize = std::max(BLOCK_SIZE, bytes.size());
+        blocks.emplace_back(new char[blockSize]);
+        cursor = blocks.back().get();
+        remaining = blockSize;
+    }
+    char* stored = cursor;
+    std::memcpy(stored, bytes.data(), bytes.size());
+    cursor += bytes.size();
+    remaining -= bytes.size();
+    return stored;
+}
+
+void StringArena::clear() {
+    blocks.clear();
+    cursor = nullptr;
+    remaining = 0;
+}
+
+// 64-bit hash that mixes eight bytes at a time
+inline uint64_t hashBytes(const char* data, size_t length) {
+    const uint64_t mul = 0x9E3779B97F4A7C15ull;
+    uint64_t h = length * mul;
+    while (length >= 8) {
+        uint64_t k;
+        std::memcpy(&k, data, 8);
+        h = (h ^ k) * mul;
+        h ^= h >> 32;
+        data += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        uint64_t k = 0;
+        std::memcpy(&k, data, length);
+        h = (h ^ k) * mul;
+    }
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 32);
+}
+
+// Flat open-addressing (linear probing) table from word to count. Keys are
+// interned in the table's own arena, so a word costs one copy on first insert
+// and no allocation afterwards. Iteration order is unspecified; callers sort
+// only when a report needs it.
+class WordTable {
+public:
+    struct Entry {
+        const char* key = nullptr; // nullptr marks an empty slot
+        uint32_t length = 0;
+        uint32_t hash = 0;
+        uint64_t count = 0;
+        uint32_t syllables : 31; // Filled in by the owner on first insert, as is
+        uint32_t stopWord : 1;   // stopWord; both zeroed with the rest of the entry
+        uint32_t id = 0;         // Dense, in order of first insert
+        
+        std::string_view word() const { return std::string_view(key, length); }
+    };
+
+private:
+    std::vector<Entry> slots;
+    size_t used = 0;
+    StringArena arena;
+    std::vector<std::string_view> idWords; // Word of each ID
+    uint64_t growths = 0; // Kept across clear(), for the analyzer's stats
     
-    // Helper functions
-    std::string toLowerCase(const std::string& word);
-    std::string cleanWord(const std::string& word);
-    int countSyllables(const std::string& word);
-    bool isVowel(char c);
-    void processText();
+    void grow();
+
+public:
+    WordTable() : slots(16) {}
+    WordTable(const WordTable&) = delete;
+    WordTable& operator=(const WordTable&) = delete;
+    
+    // Entry of a word, inserted with a zero count when new
+    Entry& entry(std::string_view word);
+    uint64_t& operator[](std::string_view word) { return entry(word).count; }
+    const Entry* find(std::string_view word) const;
+    std::string_view wordById(uint32_t id) const { return idWords[id]; }
+    size_t idCount() const { return idWords.size(); }
+    // Lower a word's count, removing it once it reaches zero
+    void subtract(std::string_view word, uint64_t amount);
+    void clear();
+    size_t size() const { return used; }
+    uint64_t rehashes() const { return growths; }
+    
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Entry& entry : slots) {
+            if (entry.key) fn(entry);
+        }
+    }
+    
+    // Entries may be updated in place, but not their keys
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (Entry& entry : slots) {
+            if (entry.key) fn(entry);
+        }
+    }
+};
+
+WordTable::Entry& WordTable::entry(std::string_view word) {
+    uint32_t hash = static_cast<uint32_t>(hashBytes(word.data(), word.size()));
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Entry& entry = slots[i];
+        if (!entry.key) {
+            // Keep the load factor under 0.7 so probe runs stay short
+            if ((used + 1) * 10 > slots.size() * 7) {
+                grow();
+                return this->entry(word);
+            }
+            entry.key = arena.intern(word);
+            entry.length = static_cast<uint32_t>(word.size());
+            entry.hash = hash;
+            entry.id = static_cast<uint32_t>(idWords.size());
+            idWords.push_back(entry.word());
+            used++;
+            return entry;
+        }
+        if (entry.hash == hash && entry.word() == word) return entry;
+    }
+}
+
+const WordTable::Entry* WordTable::find(std::string_view word) const {
+    uint32_t hash = static_cast<uint32_t>(hashBytes(word.data(), word.size()));
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; slots[i].key; i = (i + 1) & mask) {
+        if (slots[i].hash == hash && slots[i].word() == word) return &slots[i];
+    }
+    return nullptr;
+}
+
+void WordTable::subtract(std::string_view word, uint64_t amount) {
+    const Entry* found = find(word);
+    if (!found) return;
+    size_t hole = found - slots.data();
+    if (slots[hole].count > amount) {
+        slots[hole].count -= amount;
+        return;
+    }
+    
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole when the hole lies between their home slot and where they sit now.
+    // The key bytes stay in the arena until the table is cleared.
+    size_t mask = slots.size() - 1;
+    for (size_t i = (hole + 1) & mask; slots[i].key; i = (i + 1) & mask) {
+        size_t home = slots[i].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole] = Entry();
+    used--;
+}
+
+void WordTable::grow() {
+    growths++;
+    std::vector<Entry> old(slots.size() * 2);
+    old.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (const Entry& entry : old) {
+        if (!entry.key) continue;
+        size_t i = entry.hash & mask;
+        while (slots[i].key) i = (i + 1) & mask;
+        slots[i] = entry; // Keys stay where they are in the arena
+    }
+}
+
+void WordTable::clear() {
+    slots.assign(16, Entry());
+    idWords.clear();
+    used = 0;
+    arena.clear();
+}
+
+// Built-in English stop words, cleaned the way the tokenizer cleans text
+// (lowercase, apostrophes dropped)
+constexpr const char* BUILTIN_STOP_WORDS[] = {
+    "a", "about", "above", "after", "again", "against", "all", "am", "an", "and",
+    "any", "are", "as", "at", "be", "because", "been", "before", "being", "below",
+    "between", "both", "but", "by", "can", "could", "did", "do", "does", "doing",
+    "dont", "down", "during", "each", "few", "for", "from", "further", "had", "has",
+    "have", "having", "he", "her", "here", "hers", "herself", "him", "himself", "his",
+    "how", "i", "if", "in", "into", "is", "it", "its", "itself", "just",
+    "me", "more", "most", "my", "myself", "no", "nor", "not", "now", "of",
+    "off", "on", "once", "only", "or", "other", "our", "ours", "ourselves", "out",
+    "over", "own", "same", "she", "should", "so", "some", "such", "than", "that",
+    "the", "their", "theirs", "them", "themselves", "then", "there", "these", "they", "this",
+    "those", "through", "to", "too", "under", "until", "up", "very", "was", "we",
+    "were", "what", "when", "where", "which", "while", "who", "whom", "why", "will",
+    "with", "would", "you", "your", "yours", "yourself", "yourselves",
+};
+
+// Perfect hash over the built-in list, found at compile time: the seed is
+// the first one that sends every stop word to its own slot, so a lookup is
+// one hash, one slot and one compare with no probing.
+class StopWordSet {
+public:
+    static constexpr size_t COUNT = sizeof(BUILTIN_STOP_WORDS) / sizeof(BUILTIN_STOP_WORDS[0]);
+    static constexpr size_t SLOTS = 2048;
+    
+    static constexpr uint32_t hash(const char* word, size_t length, uint32_t seed) {
+        uint32_t h = seed ^ static_cast<uint32_t>(length);
+        for (size_t i = 0; i < length; i++) {
+            h = (h ^ static_cast<unsigned char>(word[i])) * 16777619u;
+        }
+        return (h ^ (h >> 15)) & (SLOTS - 1);
+    }
+    
+    constexpr StopWordSet() : seed(findSeed()), slots(), lengths() {
+        for (size_t i = 0; i < SLOTS; i++) slots[i] = COUNT; // The empty word, length 0
+        for (size_t i = 0; i < COUNT; i++) {
+            lengths[i] = static_cast<uint8_t>(lengthOf(BUILTIN_STOP_WORDS[i]));
+            slots[hash(BUILTIN_STOP_WORDS[i], lengths[i], seed)] = static_cast<uint8_t>(i);
+        }
+    }
+    
+    bool contains(std::string_view word) const {
+        size_t i = slots[hash(word.data(), word.size(), seed)];
+        return lengths[i] == word.size() && word.size() && std::memcmp(BUILTIN_STOP_WORDS[i], word.data(), word.size()) == 0;
+    }
+
+private:
+    static_assert(COUNT < 255, "Slots hold word numbers in one byte");
+    uint32_t seed;
+    uint8_t slots[SLOTS];        // Word number in each slot, COUNT when empty
+    uint8_t lengths[COUNT + 1];
+    
+    static constexpr size_t lengthOf(const char* word) {
+        size_t length = 0;
+        while (word[length]) length++;
+        return length;
+    }
+    
+    static constexpr uint32_t findSeed() {
+        for (uint32_t seed = 1;; seed++) {
+            uint64_t taken[SLOTS / 64] = {};
+            size_t placed = 0;
+            for (; placed < COUNT; placed++) {
+                const char* word = BUILTIN_STOP_WORDS[placed];
+                uint32_t slot = hash(word, lengthOf(word), seed);
+                uint64_t bit = uint64_t(1) << (slot % 64);
+                if (taken[slot / 64] & bit) break;
+                taken[slot / 64] |= bit;
+            }
+            if (placed == COUNT) return seed;
+        }
+    }
+};
+
+constexpr StopWordSet BUILTIN_STOP_WORD_SET;
+
+// Trigram of word IDs packed as (first << 32 | second, third)
+struct TrigramKey {
+    uint64_t high;
+    uint64_t low;
+    
+    bool operator==(const TrigramKey& other) const { return high == other.high && low == other.low; }
+};
+
+inline uint64_t bigramKey(uint32_t first, uint32_t second) {
+    return static_cast<uint64_t>(first) << 32 | second;
+}
+
+inline TrigramKey trigramKey(uint32_t first, uint32_t second, uint32_t third) {
+    return {bigramKey(first, second), third};
+}
+
+inline uint64_t mixKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    return key ^ (key >> 33);
+}
+
+inline uint64_t mixKey(const TrigramKey& key) {
+    return mixKey(key.high ^ mixKey(key.low));
+}
+
+// Flat open-addressing table from a packed n-gram key to its count, so
+// phrases are hashed as one or two integers rather than as strings
+template <typename Key>
+class NGramTable {
+private:
+    struct Slot {
+        Key key{};
+        uint64_t count = 0; // Zero marks an empty slot
+    };
+    std::vector<Slot> slots;
+    size_t used = 0;
+    
+    size_t findSlot(const Key& key) const {
+        size_t mask = slots.size() - 1;
+        size_t i = mixKey(key) & mask;
+        while (slots[i].count && !(slots[i].key == key)) i = (i + 1) & mask;
+        return i;
+    }
     
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.count) slots[findSlot(slot.key)] = slot;
+        }
+    }
+
 public:
-    TextAnalyzer();
-    bool loadFromFile(const std::string& filename);
-    void loadFromString(const std::string& inputText);
+    NGramTable() : slots(16) {}
     
-    // Analysis functions
-    void analyzeWordFrequency();
-    void displayWordFrequency(int topN = 10);
-    void displayBasicStats();
-    double calculateReadingLevel();
-    void findMostCommonWords(int count = 5);
-    void findLeastCommonWords(int count = 5);
-    void exportResults(const std::string& filename);
+    void add(const Key& key, uint64_t amount = 1) {
+        size_t i = findSlot(key);
+        if (!slots[i].count) {
+            if ((used + 1) * 10 > slots.size() * 7) {
+                grow();
+                i = findSlot(key);
+            }
+            slots[i].key = key;
+            used++;
+        }
+        slots[i].count += amount;
+    }
+    
+    // Lower a count, removing the key at zero (backward-shift deletion)
+    void subtract(const Key& key, uint64_t amount) {
+        size_t hole = findSlot(key);
+        if (!slots[hole].count) return;
+        if (slots[hole].count > amount) {
+            slots[hole].count -= amount;
+            return;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = (hole + 1) & mask; slots[i].count; i = (i + 1) & mask) {
+            size_t home = mixKey(slots[i].key) & mask;
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Slot();
+        used--;
+    }
+    
+    void clear() {
+        slots.assign(16, Slot());
+        used = 0;
+    }
+    
+    size_t size() const { return used; }
+    
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : slots) {
+            if (slot.count) fn(slot.key, slot.count);
+        }
+    }
+};
+
+// Bigram and trigram counts over a stream of word IDs. The stream runs
+// across sentence boundaries, like the word counts do.
+class NGramCounter {
+public:
+    NGramTable<uint64_t> bigrams;
+    NGramTable<TrigramKey> trigrams;
+    uint32_t history[3];   // Last words seen, oldest first
+    size_t historyLength = 0;
+    uint32_t head[2];      // First words seen, used to stitch worker slices
+    size_t headLength = 0;
+    
+    void push(uint32_t id) {
+        if (historyLength >= 1) bigrams.add(bigramKey(history[historyLength - 1], id));
+        if (historyLength >= 2) trigrams.add(trigramKey(history[historyLength - 2], history[historyLength - 1], id));
+        if (headLength < 2) head[headLength++] = id;
+        remember(id);
+    }
+    
+    // Take back the n-grams that end at the most recent word
+    void popLast() {
+        if (historyLength == 0) return;
+        uint32_t id = history[historyLength - 1];
+        if (historyLength >= 2) bigrams.subtract(bigramKey(history[historyLength - 2], id), 1);
+        if (historyLength >= 3) trigrams.subtract(trigramKey(history[0], history[1], id), 1);
+        historyLength--;
+    }
+    
+    // Add the counts of another counter whose word IDs map through idMap,
+    // then the n-grams that cross from this stream into the other one
+    void append(const NGramCounter& other, const std::vector<uint32_t>& idMap) {
+        other.bigrams.forEach([&](uint64_t key, uint64_t count) {
+            bigrams.add(bigramKey(idMap[key >> 32], idMap[key & 0xFFFFFFFF]), count);
+        });
+        other.trigrams.forEach([&](const TrigramKey& key, uint64_t count) {
+            trigrams.add(trigramKey(idMap[key.high >> 32], idMap[key.high & 0xFFFFFFFF], idMap[key.low]), count);
+        });
+        
+        for (size_t k = 0; k < other.headLength; k++) {
+            uint32_t id = idMap[other.head[k]];
+            if (k == 0 && historyLength >= 1) bigrams.add(bigramKey(history[historyLength - 1], id));
+            if (k == 0 && historyLength >= 2) trigrams.add(trigramKey(history[historyLength - 2], history[historyLength - 1], id));
+            if (k == 1 && historyLength >= 1) trigrams.add(trigramKey(history[historyLength - 1], idMap[other.head[0]], id));
+        }
+        for (size_t k = 0; k < other.historyLength; k++) remember(idMap[other.history[k]]);
+    }
+    
+    void clear() {
+        bigrams.clear();
+        trigrams.clear();
+        historyLength = 0;
+        headLength = 0;
+    }
+
+private:
+    void remember(uint32_t id) {
+        if (historyLength == 3) {
+            history[0] = history[1];
+            history[1] = history[2];
+            historyLength = 2;
+        }
+        history[historyLength++] = id;
+    }
+};
+
+// Token positions of every word, stored per word ID as varint-coded gaps
+// between successive positions. Positions count words from 0. Every
+// SKIP_INTERVAL postings a skip entry records the position reached and where
+// decoding resumes, so a cursor can jump over whole blocks of a long list.
+class PositionalIndex {
+private:
+    static constexpr uint64_t SKIP_INTERVAL = 128;
+    struct Skip {
+        uint64_t position; // Of the block's last posting
+        size_t offset;     // Byte just after it
+        uint64_t count;    // Postings up to and including it
+    };
+    struct Postings {
+        std::vector<uint8_t> bytes;
+        std::vector<Skip> skips;
+        uint64_t last = 0;
+        uint64_t count = 0;
+    };
+    std::vector<Postings> lists;
+    uint64_t nextPosition = 0;
+
+public:
+    // Reads one word's positions in ascending order
+    class Cursor {
+    public:
+        explicit Cursor(const Postings* list) : list(list) { next(); }
+        bool done() const { return finished; }
+        uint64_t position() const { return current; }
+        void next();
+        // Move to the first position at or after target
+        void seek(uint64_t target);
+    
+    private:
+        const Postings* list;
+        size_t offset = 0;  // Next byte to decode
+        uint64_t read = 0;  // Postings decoded so far
+        uint64_t current = 0;
+        bool finished = false;
+    };
+    
+    void add(uint32_t id);
+    // Step over a token that has no word ID
+    void skip() { nextPosition++; }
+    Cursor cursor(uint32_t id) const { return Cursor(id < lists.size() ? &lists[id] : nullptr); }
+    uint64_t frequency(uint32_t id) const { return id < lists.size() ? lists[id].count : 0; }
+    void clear();
+};
+
+void PositionalIndex::add(uint32_t id) {
+    if (id >= lists.size()) lists.resize(static_cast<size_t>(id) + 1);
+    Postings& list = lists[id];
+    uint64_t gap = nextPosition - list.last; // The first gap is the position itself
+    list.last = nextPosition++;
+    list.count++;
+    // LEB128: seven bits per byte, high bit set while more bytes follow
+    while (gap >= 0x80) {
+        list.bytes.push_back(static_cast<uint8_t>(gap | 0x80));
+        gap >>= 7;
+    }
+    list.bytes.push_back(static_cast<uint8_t>(gap));
+    if (list.count % SKIP_INTERVAL == 0) list.skips.push_back({list.last, list.bytes.size(), list.count});
+}
+
+void PositionalIndex::Cursor::next() {
+    if (!list || offset >= list->bytes.size()) {
+        finished = true;
+        return;
+    }
+    uint64_t gap = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = list->bytes[offset++];
+        gap |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    current += gap;
+    read++;
+}
+
+void PositionalIndex::Cursor::seek(uint64_t target) {
+    if (finished || current >= target) return;
+    // When target lies past the end of the cursor's block, jump to the last
+    // block ending before it; nearer targets are simply decoded up to
+    const std::vector<Skip>& skips = list->skips;
+    size_t ahead = static_cast<size_t>(read / SKIP_INTERVAL); // First skip past the cursor
+    if (ahead < skips.size() && skips[ahead].position < target) {
+        auto after = std::upper_bound(skips.begin() + ahead, skips.end(), target,
+            [](uint64_t value, const Skip& skip) { return value <= skip.position; });
+        const Skip& skip = *(after - 1);
+        current = skip.position;
+        offset = skip.offset;
+        read = skip.count;
+    }
+    while (!finished && current < target) next();
+}
+
+void PositionalIndex::clear() {
+    lists.clear();
+    lists.shrink_to_fit();
+    nextPosition = 0;
+}
+
+// State of a tokenizer scan, carried from one block of input to the next.
+// Most tokens are already clean: one run of lower-case letters and digits,
+// perhaps with punctuation before or after it. Such a word is handed out as
+// a view of the input itself; scratch is only filled once cleaning would
+// change the run (upper case, or punctuation inside the word).
+struct TokenizerState {
+    bool inToken = false;
+    bool copying = false;           // The word is in scratch, not a view
+    const char* viewStart = nullptr; // Clean run of the current token, if any
+    const char* viewEnd = nullptr;
+    uint64_t sentences = 0;
+    
+    void startToken() {
+        inToken = true;
+        copying = false;
+        viewStart = viewEnd = nullptr;
+    }
+    
+    // Move the clean run into scratch so cleaned bytes can follow it
+    void startCopying(std::string& scratch) {
+        scratch.assign(viewStart, viewEnd - viewStart);
+        copying = true;
+    }
+    
+    // Move a token still open at the end of the input into scratch, so the
+    // scan can resume on another buffer once this one is gone
+    void detach(std::string& scratch) {
+        if (inToken && !copying) {
+            if (viewStart) startCopying(scratch);
+            else scratch.clear();
+            copying = true;
+        }
+    }
+};
+
+template <typename OnWord>
+inline void endToken(TokenizerState& state, const std::string& scratch, OnWord& onWord) {
+    if (state.copying) {
+        if (!scratch.empty()) onWord(std::string_view(scratch));
+    } else if (state.viewStart) {
+        onWord(std::string_view(state.viewStart, state.viewEnd - state.viewStart));
+    }
+    state.inToken = false;
+}
+
+// Byte-at-a-time tokenizer; the reference behavior for the vector paths and
+// the fallback for non-ASCII bytes and short tails
+template <typename OnWord>
+void scanScalar(const char* p, const char* end, TokenizerState& state, std::string& scratch, OnWord& onWord) {
+    for (; p < end; p++) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (isSpaceByte(c)) {
+            if (state.inToken) endToken(state, scratch, onWord);
+            continue;
+        }
+        if (!state.inToken) state.startToken();
+        // Count sentences (simplified - look for .!?)
+        if (c == '.' || c == '!' || c == '?') {
+            state.sentences++;
+        } else if (std::isalnum(c)) {
+            char lower = static_cast<char>(std::tolower(c));
+            if (!state.copying) {
+                if (lower == *p && (!state.viewStart || state.viewEnd == p)) {
+                    if (!state.viewStart) state.viewStart = p;
+                    state.viewEnd = p + 1;
+                    continue;
+                }
+                state.startCopying(scratch);
+            }
+            scratch += lower;
+        }
+    }
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define TEXT_ANALYZER_HAS_SIMD 1
+#include <immintrin.h>
+
+// Per-byte classes of one 16 or 32 byte block, one bit per byte
+struct BlockMasks {
+    uint32_t space;  // Word separators
+    uint32_t keep;   // ASCII letters and digits
+    uint32_t term;   // Sentence terminators
+    uint32_t high;   // Non-ASCII bytes
+    uint32_t upper;  // ASCII upper case
+};
+
+// Feed one classified block, starting at `block` in the input, to the
+// tokenizer. A clean run of kept bytes extends the token's view of the input;
+// otherwise kept bytes are copied from `lowered`, which holds the block with
+// ASCII upper case already folded, in whole runs when they are contiguous.
+template <size_t Width, typename OnWord>
+inline void consumeBlock(const BlockMasks& m, const char* block, const char* lowered, TokenizerState& state,
+                         std::string& scratch, OnWord& onWord) {
+    const uint32_t full = Width == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+    state.sentences += __builtin_popcount(m.term);
+    
+    size_t i = 0;
+    while (i < Width) {
+        uint32_t from = full & ~((1u << i) - 1); // Bits i and above
+        if (!state.inToken) {
+            uint32_t starts = ~m.space & from;
+            if (!starts) return;
+            i = __builtin_ctz(starts);
+            from = full & ~((1u << i) - 1);
+            state.startToken();
+        }
+        
+        uint32_t stops = m.space & from;
+        size_t end = stops ? __builtin_ctz(stops) : Width;
+        uint32_t segment = static_cast<uint32_t>(((1ull << end) - 1) & ~((1ull << i) - 1));
+        uint32_t kept = m.keep & segment;
+        if (kept && !state.copying) {
+            // One run of kept bytes with no upper case, following on from the
+            // view so far, needs no copy
+            size_t first = __builtin_ctz(kept);
+            size_t last = 31 - __builtin_clz(kept);
+            uint32_t run = static_cast<uint32_t>(((2ull << last) - 1) & ~((1ull << first) - 1));
+            if (kept == run && !(m.upper & run) && (!state.viewStart || state.viewEnd == block + first)) {
+                if (!state.viewStart) state.viewStart = block + first;
+                state.viewEnd = block + last + 1;
+                kept = 0;
+            } else {
+                state.startCopying(scratch);
+            }
+        }
+        if (kept == segment) {
+            scratch.append(lowered + i, end - i);
+        } else {
+            for (; kept; kept &= kept - 1) scratch += lowered[__builtin_ctz(kept)];
+        }
+        
+        if (end == Width) return; // The word continues in the next block
+        endToken(state, scratch, onWord);
+        i = end;
+    }
+}
+
+inline BlockMasks classifySSE2(const char* p, char* lowered) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    auto inRange = [v](char lo, char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                             _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+    };
+    __m128i upper = inRange('A', 'Z');
+    __m128i keep = _mm_or_si128(_mm_or_si128(upper, inRange('a', 'z')), inRange('0', '9'));
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange('\t', '\r'));
+    __m128i term = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('.')),
+                                             _mm_cmpeq_epi8(v, _mm_set1_epi8('!'))),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('?')));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lowered),
+                     _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+    return {static_cast<uint32_t>(_mm_movemask_epi8(space)), static_cast<uint32_t>(_mm_movemask_epi8(keep)),
+            static_cast<uint32_t>(_mm_movemask_epi8(term)), static_cast<uint32_t>(_mm_movemask_epi8(v)),
+            static_cast<uint32_t>(_mm_movemask_epi8(upper))};
+}
+
+__attribute__((target("avx2")))
+inline BlockMasks classifyAVX2(const char* p, char* lowered) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    // Lambdas do not inherit the target attribute, so the range checks are spelled out
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('a' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), v));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    __m256i control = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v));
+    __m256i keep = _mm256_or_si256(_mm256_or_si256(upper, lower), digit);
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), control);
+    __m256i term = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('.')),
+                                                   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('!'))),
+                                   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('?')));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lowered),
+                        _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20))));
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(space)), static_cast<uint32_t>(_mm256_movemask_epi8(keep)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(term)), static_cast<uint32_t>(_mm256_movemask_epi8(v)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(upper))};
+}
+
+template <typename OnWord>
+const char* scanSSE2(const char* p, const char* end, TokenizerState& state, std::string& scratch, OnWord& onWord) {
+    alignas(16) char lowered[16];
+    for (; end - p >= 16; p += 16) {
+        BlockMasks m = classifySSE2(p, lowered);
+        if (m.high) scanScalar(p, p + 16, state, scratch, onWord);
+        else consumeBlock<16>(m, p, lowered, state, scratch, onWord);
+    }
+    return p;
+}
+
+template <typename OnWord>
+__attribute__((target("avx2")))
+const char* scanAVX2(const char* p, const char* end, TokenizerState& state, std::string& scratch, OnWord& onWord) {
+    alignas(32) char lowered[32];
+    for (; end - p >= 32; p += 32) {
+        BlockMasks m = classifyAVX2(p, lowered);
+        if (m.high) scanScalar(p, p + 32, state, scratch, onWord);
+        else consumeBlock<32>(m, p, lowered, state, scratch, onWord);
+    }
+    return p;
+}
+#endif
+
+// Split a byte range on whitespace, count its sentence terminators (.!?) and
+// call onWord with each token reduced to its lower-cased alphanumeric characters,
+// as a string_view valid only during the call. It points into the input when
+// the token needed no cleaning, else into scratch. Tokens without any
+// alphanumerics are skipped. Returns the terminator count.
+// On x86-64 the input is classified 16 or 32 bytes at a time (SSE2, or AVX2
+// when the CPU has it); blocks with non-ASCII bytes take the scalar path.
+template <typename OnWord>
+uint64_t forEachWord(const char* data, size_t length, std::string& scratch, OnWord&& onWord) {
+    const char* p = data;
+    const char* end = data + length;
+    TokenizerState state;
+    
+#ifdef TEXT_ANALYZER_HAS_SIMD
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    p = hasAVX2 ? scanAVX2(p, end, state, scratch, onWord) : scanSSE2(p, end, state, scratch, onWord);
+#endif
+    scanScalar(p, end, state, scratch, onWord);
+    
+    if (state.inToken) endToken(state, scratch, onWord);
+    return state.sentences;
+}
+
+// Walk [begin, end) of data in windows of roughly windowSize bytes that each
+// end on whitespace, so no word straddles two windows
+template <typename Fn>
+void forEachWindow(const char* data, size_t begin, size_t end, size_t windowSize, Fn&& fn) {
+    while (begin < end) {
+        size_t stop = std::min(begin + windowSize, end);
+        while (stop < end && !isSpaceByte(data[stop])) stop++;
+        fn(begin, stop - begin);
+        begin = stop;
+    }
+}
+
+// Count-Min sketch: a depth x width matrix of counters. A word's estimate is
+// the smallest of its counters, which never undercounts and overcounts by at
+// most epsilon() * total() with probability 1 - delta().
+class CountMinSketch {
+private:
+    size_t width; // Power of two
+    size_t depth;
+    std::vector<uint64_t> counters;
+    uint64_t totalCount = 0;
+    
+    // Row i uses hash h1 + i * h2 (Kirsch-Mitzenmacher double hashing)
+    size_t column(uint64_t hash, size_t row) const {
+        uint32_t h1 = static_cast<uint32_t>(hash);
+        uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+        return (h1 + row * h2) & (width - 1);
+    }
+
+public:
+    CountMinSketch(size_t width, size_t depth);
+    
+    void add(uint64_t hash, int64_t amount = 1);
+    void merge(const CountMinSketch& other);
+    uint64_t estimate(uint64_t hash) const;
+    void clear();
+    
+    uint64_t total() const { return totalCount; }
+    double epsilon() const { return 2.718281828459045 / width; }
+    double delta() const { return std::exp(-static_cast<double>(depth)); }
+};
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth) : width(1), depth(std::max<size_t>(depth, 1)) {
+    while (this->width < width) this->width <<= 1;
+    counters.assign(this->width * this->depth, 0);
+}
+
+// A negative amount takes back an earlier add
+void CountMinSketch::add(uint64_t hash, int64_t amount) {
+    for (size_t row = 0; row < depth; row++) {
+        counters[row * width + column(hash, row)] += amount;
+    }
+    totalCount += amount;
+}
+
+// Only valid between sketches of the same shape
+void CountMinSketch::merge(const CountMinSketch& other) {
+    for (size_t i = 0; i < counters.size(); i++) counters[i] += other.counters[i];
+    totalCount += other.totalCount;
+}
+
+uint64_t CountMinSketch::estimate(uint64_t hash) const {
+    uint64_t best = UINT64_MAX;
+    for (size_t row = 0; row < depth; row++) {
+        best = std::min(best, counters[row * width + column(hash, row)]);
+    }
+    return best;
+}
+
+void CountMinSketch::clear() {
+    std::fill(counters.begin(), counters.end(), 0);
+    totalCount = 0;
+}
+
+// Space-Saving summary of the most frequent words in a fixed number of
+// counters. When a new word arrives and all counters are taken, it replaces
+// the word with the smallest count and inherits that count as its error, so
+// every tracked word's true count lies in [count - error, count].
+class SpaceSaving {
+public:
+    struct Counter {
+        std::string word;
+        uint64_t hash = 0;
+        uint64_t count = 0;
+        uint64_t error = 0;
+    };
+
+private:
+    size_t capacity;
+    std::vector<Counter> counters;
+    std::vector<uint32_t> heap;     // Counter indices, smallest count on top
+    std::vector<uint32_t> heapPos;  // Where each counter sits in the heap
+    std::vector<int32_t> index;     // Open-addressing word index, -1 = empty
+    
+    size_t findSlot(std::string_view word, uint64_t hash) const;
+    void eraseFromIndex(uint32_t counter);
+    void swapHeap(size_t a, size_t b);
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+    void insertCounter(const Counter& counter);
+
+public:
+    explicit SpaceSaving(size_t capacity);
+    
+    void offer(std::string_view word, uint64_t hash);
+    // Take back the most recent offer of a word
+    void undo(std::string_view word, uint64_t hash);
+    void merge(const SpaceSaving& other);
+    void clear();
+    
+    // Smallest tracked count, the error given to a word entering a full summary
+    uint64_t minCount() const { return counters.size() < capacity ? 0 : counters[heap[0]].count; }
+    const Counter* find(std::string_view word, uint64_t hash) const;
+    const std::vector<Counter>& tracked() const { return counters; }
 };
 
-// Constructor
-TextAnalyzer::TextAnalyzer() : totalWords(0), totalSentences(0), totalSyllables(0) {}
+SpaceSaving::SpaceSaving(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {
+    size_t slots = 16;
+    while (slots < this->capacity * 2) slots <<= 1;
+    index.assign(slots, -1);
+    counters.reserve(this->capacity);
+}
+
+size_t SpaceSaving::findSlot(std::string_view word, uint64_t hash) const {
+    size_t mask = index.size() - 1;
+    size_t i = hash & mask;
+    while (index[i] >= 0) {
+        const Counter& c = counters[index[i]];
+        if (c.hash == hash && c.word == word) break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Backward-shift deletion, as in WordTable::subtract
+void SpaceSaving::eraseFromIndex(uint32_t counter) {
+    size_t mask = index.size() - 1;
+    size_t hole = findSlot(counters[counter].word, counters[counter].hash);
+    for (size_t i = (hole + 1) & mask; index[i] >= 0; i = (i + 1) & mask) {
+        size_t home = counters[index[i]].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            index[hole] = index[i];
+            hole = i;
+        }
+    }
+    index[hole] = -1;
+}
+
+void SpaceSaving::swapHeap(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    heapPos[heap[a]] = static_cast<uint32_t>(a);
+    heapPos[heap[b]] = static_cast<uint32_t>(b);
+}
+
+void SpaceSaving::siftUp(size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (counters[heap[parent]].count <= counters[heap[pos]].count) break;
+        swapHeap(pos, parent);
+        pos = parent;
+    }
+}
+
+void SpaceSaving::siftDown(size_t pos) {
+    for (;;) {
+        size_t smallest = pos;
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); child++) {
+            if (counters[heap[child]].count < counters[heap[smallest]].count) smallest = child;
+        }
+        if (smallest == pos) return;
+        swapHeap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void SpaceSaving::insertCounter(const Counter& counter) {
+    uint32_t id = static_cast<uint32_t>(counters.size());
+    index[findSlot(counter.word, counter.hash)] = static_cast<int32_t>(id);
+    counters.push_back(counter);
+    heap.push_back(id);
+    heapPos.push_back(static_cast<uint32_t>(heap.size() - 1));
+    siftUp(heap.size() - 1);
+}
+
+void SpaceSaving::offer(std::string_view word, uint64_t hash) {
+    size_t slot = findSlot(word, hash);
+    if (index[slot] >= 0) {
+        uint32_t id = static_cast<uint32_t>(index[slot]);
+        counters[id].count++;
+        siftDown(heapPos[id]);
+        return;
+    }
+    if (counters.size() < capacity) {
+        insertCounter({std::string(word), hash, 1, 0});
+        return;
+    }
+    
+    // Evict the smallest counter and give its count to the new word
+    uint32_t id = heap[0];
+    eraseFromIndex(id);
+    Counter& victim = counters[id];
+    victim.word.assign(word.data(), word.size());
+    victim.hash = hash;
+    victim.error = victim.count;
+    victim.count++;
+    index[findSlot(word, hash)] = static_cast<int32_t>(id);
+    siftDown(0);
+}
+
+// If the offer evicted another word, that word stays evicted; the new word
+// keeps the inherited count as error, so its bounds still hold
+void SpaceSaving::undo(std::string_view word, uint64_t hash) {
+    size_t slot = findSlot(word, hash);
+    if (index[slot] < 0) return;
+    uint32_t id = static_cast<uint32_t>(index[slot]);
+    Counter& c = counters[id];
+    if (c.count == 0) return;
+    c.count--;
+    c.error = std::min(c.error, c.count);
+    siftUp(heapPos[id]);
+}
+
+// Mergeable-summary rule: a word missing from one side may have had up to
+// that side's minimum count there, so the minimum is added to its count and
+// its error. The largest `capacity` results are kept.
+void SpaceSaving::merge(const SpaceSaving& other) {
+    std::vector<Counter> combined;
+    combined.reserve(counters.size() + other.counters.size());
+    uint64_t ownMin = minCount();
+    uint64_t otherMin = other.minCount();
+    
+    for (const Counter& c : counters) {
+        Counter merged = c;
+        const Counter* match = other.find(c.word, c.hash);
+        merged.count += match ? match->count : otherMin;
+        merged.error += match ? match->error : otherMin;
+        combined.push_back(std::move(merged));
+    }
+    for (const Counter& c : other.counters) {
+        if (find(c.word, c.hash)) continue;
+        Counter merged = c;
+        merged.count += ownMin;
+        merged.error += ownMin;
+        combined.push_back(std::move(merged));
+    }
+    
+    if (combined.size() > capacity) {
+        std::nth_element(combined.begin(), combined.begin() + capacity, combined.end(),
+                         [](const Counter& a, const Counter& b) { return a.count > b.count; });
+        combined.resize(capacity);
+    }
+    clear();
+    for (const Counter& c : combined) insertCounter(c);
+}
+
+void SpaceSaving::clear() {
+    counters.clear();
+    heap.clear();
+    heapPos.clear();
+    std::fill(index.begin(), index.end(), -1);
+}
+
+const SpaceSaving::Counter* SpaceSaving::find(std::string_view word, uint64_t hash) const {
+    int32_t id = index[findSlot(word, hash)];
+    return id >= 0 ? &counters[id] : nullptr;
+}
+
+// Approximate word counts in fixed memory: the sketch bounds any word's
+// count, and the Space-Saving summary remembers which words are frequent
+class HeavyHitters {
+public:
+    struct Estimate {
+        std::string_view word;
+        uint64_t count;      // Upper bound on the true count
+        uint64_t guaranteed; // Lower bound on the true count
+    };
+
+private:
+    CountMinSketch sketch;
+    SpaceSaving summary;
+
+public:
+    HeavyHitters(size_t topK, size_t sketchWidth, size_t sketchDepth)
+        : sketch(sketchWidth, sketchDepth), summary(topK) {}
+    
+    void add(std::string_view word) {
+        uint64_t hash = hashBytes(word.data(), word.size());
+        sketch.add(hash);
+        summary.offer(word, hash);
+    }
+    
+    void undo(std::string_view word) {
+        uint64_t hash = hashBytes(word.data(), word.size());
+        sketch.add(hash, -1);
+        summary.undo(word, hash);
+    }
+    
+    void merge(const HeavyHitters& other) {
+        sketch.merge(other.sketch);
+        summary.merge(other.summary);
+    }
+    
+    void clear() {
+        sketch.clear();
+        summary.clear();
+    }
+    
+    // The `count` words with the highest estimates, best first
+    std::vector<Estimate> top(size_t count) const;
+    
+    // With probability confidence(), no estimate exceeds its true count by more than errorBound()
+    double errorBound() const { return sketch.epsilon() * sketch.total(); }
+    double confidence() const { return 1.0 - sketch.delta(); }
+};
+
+std::vector<HeavyHitters::Estimate> HeavyHitters::top(size_t count) const {
+    std::vector<Estimate> result;
+    for (const auto& c : summary.tracked()) {
+        // Both structures overcount, so the smaller answer is the tighter one
+        uint64_t estimate = std::min(c.count, sketch.estimate(c.hash));
+        result.push_back({c.word, estimate, c.count - c.error});
+    }
+    count = std::min(count, result.size());
+    std::partial_sort(result.begin(), result.begin() + count, result.end(),
+                      [](const Estimate& a, const Estimate& b) {
+                          return a.count > b.count || (a.count == b.count && a.word < b.word);
+                      });
+    result.resize(count);
+    return result;
+}
+
+// Time and work of one analysis phase, summed over every call
+struct PhaseStats {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t bytes = 0;
+    
+    double seconds() const { return nanoseconds / 1e9; }
+};
+
+// Counters kept by an analyzer since it was made or its stats were reset
+struct AnalyzerStats {
+    PhaseStats load;    // Reading or mapping input; bytes read
+    PhaseStats process; // Tokenizing and counting; bytes counted
+    PhaseStats report;  // Ranking and selecting words for reports
+    PhaseStats output;  // Writing reports and exports; bytes written
+    uint64_t tokens = 0;        // Words counted
+    uint64_t uniqueInserts = 0; // Words new to the table
+    uint64_t rehashes = 0;      // Word table growths, worker tables included
+};
+
+// Adds the time from construction to destruction to a phase
+class PhaseTimer {
+private:
+    PhaseStats& phase;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    explicit PhaseTimer(PhaseStats& phase) : phase(phase), started(std::chrono::steady_clock::now()) {}
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+    ~PhaseTimer() {
+        phase.calls++;
+        phase.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+};
+
+// A word and its count as shown in reports
+struct RankedWord {
+    std::string_view word;
+    uint64_t count;
+};
+
+// Report order: higher count first, ties alphabetical
+inline bool moreCommon(const RankedWord& a, const RankedWord& b) {
+    return a.count > b.count || (a.count == b.count && a.word < b.word);
+}
+
+// Least-common report order: lower count first, ties alphabetical
+inline bool lessCommon(const RankedWord& a, const RankedWord& b) {
+    return a.count < b.count || (a.count == b.count && a.word < b.word);
+}
+
+// Binary snapshot of an analysis, laid out so it can be mapped and read in
+// place: header, frequency array sorted in report order, then the string
+// pool. Fields use the writer's byte order; a reader with the other byte
+// order sees a bad version and rejects the file.
+struct SnapshotHeader {
+    char magic[8];           // "TXTSNAP\0"
+    uint32_t version;
+    uint32_t entrySize;      // sizeof(SnapshotEntry) when written
+    uint64_t totalWords;
+    uint64_t totalSentences; // Raw terminator count
+    uint64_t totalSyllables;
+    uint64_t entryCount;
+    uint64_t entriesOffset;
+    uint64_t poolOffset;
+    uint64_t poolBytes;
+};
+
+struct SnapshotEntry {
+    uint64_t count;
+    uint64_t offset; // Into the string pool
+    uint32_t length;
+    uint32_t syllables;
+};
+
+constexpr char SNAPSHOT_MAGIC[8] = {'T', 'X', 'T', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// Flesch-Kincaid grade of the window ending at a word
+struct ReadabilityPoint {
+    uint64_t word;     // Words read so far
+    uint64_t sentence; // Sentence terminators read so far
+    double grade;
+};
+
+// Rolling readability over the last `window` words or sentences, kept up to
+// date one token at a time. Per-token (or per-sentence) figures sit in a ring
+// and running sums are adjusted as they enter and leave it, so each token
+// costs O(1) however large the window. Text may be fed in pieces of any size;
+// a point is recorded every `step` words (or sentences).
+class ReadabilityTimeline {
+private:
+    struct Unit {
+        uint64_t words = 0;
+        uint64_t syllables = 0;
+        uint64_t terminators = 0;
+    };
+    std::vector<Unit> ring; // Grows to the window size, then wraps
+    size_t window;
+    size_t next = 0;        // Ring slot the next unit goes into
+    bool bySentences;
+    size_t step;
+    Unit sums;          // Of the units in the window
+    Unit sentence;      // Sentence mode: the one still being read
+    uint64_t words = 0;
+    uint64_t sentences = 0;
+    TokenizerState state;   // The analyzer's own tokenizer, resumed across feeds
+    uint64_t attributed = 0; // Terminators already given to a unit
+    std::string scratch;
+    std::vector<ReadabilityPoint> recorded;
+    
+    void push(const Unit& unit);
+    void addWord(std::string_view word);
+    void endSentence();
+    void record();
+
+public:
+    ReadabilityTimeline(size_t window, bool bySentences, size_t step);
+    
+    // Tokenized like the analyzer's own counting
+    void feed(const char* data, size_t length);
+    // The last token, when the text does not end in whitespace
+    void finish();
+    double grade() const;
+    
+    // Points recorded since the last call
+    std::vector<ReadabilityPoint> takePoints();
+};
+
+class TextAnalyzer {
+private:
+    friend class ReadabilityTimeline; // Shares countSyllables
+    
+    // Counts gathered by one worker over its slice of the input
+    struct WordShard {
+        WordTable frequency;
+        std::unique_ptr<HeavyHitters> approx; // Used instead of frequency in approximate mode
+        uint64_t words = 0;
+        uint64_t sentences = 0;
+        uint64_t syllables = 0; // Approximate mode only
+        NGramCounter ngrams;    // Over this shard's own word IDs
+        std::string scratch;
+    };
+    
+    std::string text;
+    WordTable wordFrequency;
+    uint64_t totalWords;
+    uint64_t totalSentences;
+    uint64_t totalSyllables; // Running sum in approximate mode, else derived from the table
+    bool syllablesValid;
+    std::string scratch; // Reused buffer for the word being cleaned
+    std::string pendingTail; // Last word so far when the input did not end in whitespace
+    unsigned threadCount;
+    
+    // Where the counted text can be read again, for the positional index
+    bool textIsComplete;     // text holds everything that was counted
+    std::string mappedSource; // Or: the single file that was mapped
+    PositionalIndex index;
+    bool indexValid;
+    
+    // Stop words are still counted, so totals and phrases stay exact, but
+    // each entry is tagged on first insert and the word views skip tagged
+    // entries while filtering is on
+    WordTable userStopWords; // Added at runtime on top of the built-in list
+    bool filterStopWords;
+    
+    // Phrase counts over word IDs, kept only when enabled
+    NGramCounter ngrams;
+    bool countNGrams;
+    
+    // Approximate mode: fixed-memory counts replace wordFrequency when set
+    std::unique_ptr<HeavyHitters> heavyHitters;
+    size_t approxTopK;
+    size_t approxWidth;
+    size_t approxDepth;
+    
+    // Report views, rebuilt lazily after the counts change
+    std::vector<RankedWord> ranked;       // Every word, most common first
+    std::vector<RankedWord> topCache;     // Best topCache.size() words
+    std::vector<RankedWord> bottomCache;  // Worst bottomCache.size() words
+    bool rankedValid;
+    bool topValid;
+    bool bottomValid;
+    
+    // Loaded binary snapshot; reports read it in place until new text is added
+    std::unique_ptr<MappedFile> snapshot;
+    const SnapshotEntry* snapshotEntries;
+    const char* snapshotPool;
+    size_t snapshotCount;
+    size_t snapshotPoolBytes;
+    
+    AnalyzerStats counters;
+    
+    // Helper functions
+    static int countSyllables(std::string_view word);
+    static bool isVowel(char c);
+    void resetCounts();
+    void processBuffer(const char* data, size_t length);
+    void processRange(const char* data, size_t length, MappedFile* mapping = nullptr);
+    void processText();
+    void appendBuffer(const char* data, size_t length);
+    uint64_t sentenceCount() const;
+    uint64_t syllableCount();
+    void invalidateViews();
+    const std::vector<RankedWord>& rankedWords();
+    std::vector<RankedWord> selectWords(size_t count, bool mostCommon) const;
+    std::vector<RankedWord> topWords(size_t count);
+    std::vector<RankedWord> bottomWords(size_t count);
+    void printErrorBound(std::ostream& out) const;
+    size_t uniqueWordCount() const;
+    RankedWord snapshotWord(size_t rank) const;
+    void thawSnapshot();
+    double readingLevel();
+    std::string phraseText(uint64_t key) const;
+    std::string phraseText(const TrigramKey& key) const;
+    template <typename Key>
+    std::vector<std::pair<std::string, uint64_t>> topPhrases(const NGramTable<Key>& table, size_t count) const;
+    bool phrasesAvailable() const;
+    bool sourceText(MappedFile& file, const char*& data, size_t& length) const;
+    std::vector<std::string> queryWords(const std::string& query);
+    bool isStopWord(std::string_view word) const;
+    void tagNewWord(WordTable::Entry& entry, std::string_view word) const;
+    std::vector<HeavyHitters::Estimate> approxTop(size_t count);
+    void recount();
+    
+public:
+    TextAnalyzer();
+    
+    // Number of threads used to count large inputs (1 = serial, 0 = all cores)
+    void setThreadCount(unsigned threads);
+    
+    // Count in fixed memory instead of keeping every distinct word. Reports
+    // then list the topK heaviest words with error bounds. Counts already
+    // made are redone in the new mode when the text is still held or mapped,
+    // and cleared otherwise.
+    void setApproximateMode(bool enabled, size_t topK = 1000,
+                            size_t sketchWidth = 1 << 16, size_t sketchDepth = 4);
+    
+    // Also count bigrams and trigrams (exact mode only). Existing counts are
+    // redone or cleared as for setApproximateMode.
+    void setNGramCounting(bool enabled);
+    bool loadFromFile(const std::string& filename);
+    bool loadFromFileMapped(const std::string& filename);
+    void loadFromString(const std::string& inputText);
+    
+    // Add more text to what is already loaded, counting only the new data.
+    // A word cut by the previous input's end is joined with its continuation.
+    void appendText(const std::string& moreText);
+    bool appendFile(const std::string& filename);
+    
+    // Count a stream of unbounded size in fixed-size chunks, keeping only the
+    // word table. The raw text is discarded as soon as it has been counted.
+    bool loadFromStream(std::FILE* input, size_t chunkBytes = 8 << 20);
+    
+    // Analysis functions
+    void analyzeWordFrequency();
+    void displayWordFrequency(int topN = 10);
+    void displayBasicStats();
+    double calculateReadingLevel();
+    
+    // Reading level over a sliding window of the last `window` words (or
+    // sentences), recorded every `step` of them in one pass over the text
+    std::vector<ReadabilityPoint> readabilityTimeline(size_t window, bool bySentences, size_t step);
+    void displayReadabilityTimeline(size_t window, bool bySentences);
+    void findMostCommonWords(int count = 5);
+    void findLeastCommonWords(int count = 5);
+    void findMostCommonPhrases(int length = 2, int count = 5);
+    std::vector<RankedWord> mostCommonWords(size_t count) { return topWords(count); }
+    
+    // Positional index over the loaded text, built on first use. Queries are
+    // cleaned like the text; results are word positions counted from 0.
+    bool buildIndex();
+    std::vector<uint64_t> occurrences(const std::string& word);
+    std::vector<uint64_t> findPhrase(const std::string& phrase);
+    void displayPhraseSearch(const std::string& phrase);
+    
+    // Leave stop words out of the word frequency views and report. A user
+    // list (one or more words per line) adds to the built-in one and turns
+    // filtering on.
+    void setStopWordFiltering(bool enabled);
+    bool loadStopWords(const std::string& filename);
+    
+    void exportResults(const std::string& filename);
+    void writeReport(std::ostream& file);
+    
+    // Binary snapshot of the counts that loadSnapshot maps back in without
+    // re-reading the source text
+    bool saveSnapshot(const std::string& filename);
+    bool loadSnapshot(const std::string& filename);
+    
+    // Add another analyzer's counts to this one, as if its text were a
+    // separate document. Both must be exact, or both approximate with the
+    // same settings.
+    bool merge(const TextAnalyzer& other);
+    
+    // Per-phase timers and counters, to see where an analysis spent its time
+    const AnalyzerStats& stats() const { return counters; }
+    void resetStats() { counters = AnalyzerStats(); }
+    void displayStats() const;
+    void writeStats(std::ostream& out) const; // One JSON object
+};
+
+// Constructor
+TextAnalyzer::TextAnalyzer() : totalWords(0), totalSentences(0), totalSyllables(0), syllablesValid(true), threadCount(1),
+    textIsComplete(true), indexValid(false), filterStopWords(false), countNGrams(false),
+    approxTopK(0), approxWidth(0), approxDepth(0), rankedValid(false), topValid(false), bottomValid(false),
+    snapshotEntries(nullptr), snapshotPool(nullptr), snapshotCount(0), snapshotPoolBytes(0) {}
+
+void TextAnalyzer::setThreadCount(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    threadCount = std::max(1u, threads);
+}
+
+void TextAnalyzer::setStopWordFiltering(bool enabled) {
+    filterStopWords = enabled;
+    rankedValid = topValid = bottomValid = false;
+}
+
+bool TextAnalyzer::loadStopWords(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        forEachWord(line.data(), line.size(), scratch, [this](std::string_view word) {
+            userStopWords.entry(word);
+        });
+    }
+    
+    // Words already counted are tagged again against the longer list
+    wordFrequency.forEach([this](WordTable::Entry& entry) {
+        entry.stopWord = isStopWord(entry.word());
+    });
+    setStopWordFiltering(true);
+    return true;
+}
+
+bool TextAnalyzer::isStopWord(std::string_view word) const {
+    return BUILTIN_STOP_WORD_SET.contains(word) || (userStopWords.size() && userStopWords.find(word));
+}
+
+// Fill in what is memoized per distinct word when it enters a table
+void TextAnalyzer::tagNewWord(WordTable::Entry& entry, std::string_view word) const {
+    entry.syllables = countSyllables(word);
+    entry.stopWord = isStopWord(word);
+}
+
+void TextAnalyzer::setNGramCounting(bool enabled) {
+    if (enabled == countNGrams) return;
+    countNGrams = enabled;
+    recount();
+}
+
+void TextAnalyzer::setApproximateMode(bool enabled, size_t topK, size_t sketchWidth, size_t sketchDepth) {
+    approxTopK = topK;
+    approxWidth = sketchWidth;
+    approxDepth = sketchDepth;
+    heavyHitters.reset(enabled ? new HeavyHitters(topK, sketchWidth, sketchDepth) : nullptr);
+    recount();
+}
+
+// The counts were made under other settings, and appending to them would mix
+// the two. Count the text again when it is still at hand; streamed input and
+// snapshots cannot be recounted, so those counts are dropped.
+void TextAnalyzer::recount() {
+    if (textIsComplete && !text.empty()) {
+        processText();
+    } else if (!textIsComplete && !mappedSource.empty()) {
+        std::string filename = mappedSource;
+        loadFromFileMapped(filename);
+    } else {
+        text.clear();
+        textIsComplete = true;
+        mappedSource.clear();
+        resetCounts();
+    }
+}
+
+#ifdef TEXT_ANALYZER_HAS_MMAP
+bool MappedFile::open(const std::string& filename) {
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) { // mmap rejects empty ranges
+        ::close(fd);
+        return true;
+    }
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (mapped == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    ptr = static_cast<const char*>(mapped);
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) munmap(const_cast<char*>(ptr), length);
+    ptr = nullptr;
+    length = 0;
+}
+
+void MappedFile::release(size_t offset, size_t bytes) {
+    // madvise needs a page-aligned start, so round it down
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset - offset % pageSize;
+    if (ptr && bytes > 0) {
+        madvise(const_cast<char*>(ptr) + start, offset + bytes - start, MADV_DONTNEED);
+    }
+}
+#else
+bool MappedFile::open(const std::string& filename) {
+    close();
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+    copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    ptr = copy.data();
+    length = copy.size();
+    return true;
+}
+
+void MappedFile::close() {
+    copy.clear();
+    copy.shrink_to_fit();
+    ptr = nullptr;
+    length = 0;
+}
+
+void MappedFile::release(size_t, size_t) {}
+#endif
+
+// The token at the very end of a byte range, or an empty view when the range
+// ends in whitespace (so a following append may continue that token)
+inline std::string_view trailingToken(const char* data, size_t length) {
+    size_t start = length;
+    while (start > 0 && !isSpaceByte(data[start - 1])) start--;
+    return std::string_view(data + start, length - start);
+}
+
+// Load text from file
+bool TextAnalyzer::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    
+    // Read the whole file in one go instead of growing text line by line
+    {
+        PhaseTimer timer(counters.load);
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        text.assign(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+        file.read(&text[0], text.size());
+        text.resize(static_cast<size_t>(file.gcount()));
+        file.close();
+        counters.load.bytes += text.size();
+    }
+    
+    processText();
+    return true;
+}
+
+// Load text by tokenizing straight from a memory mapping of the file.
+// The text is never copied into memory, so only the word table stays resident.
+bool TextAnalyzer::loadFromFileMapped(const std::string& filename) {
+#ifndef TEXT_ANALYZER_HAS_MMAP
+    return loadFromFile(filename); // No mmap on this platform
+#else
+    MappedFile file;
+    {
+        // Pages are read in as they are counted, so most I/O shows up there
+        PhaseTimer timer(counters.load);
+        if (!file.open(filename)) {
+            std::cerr << "Error: Could not map file " << filename << std::endl;
+            return false;
+        }
+        counters.load.bytes += file.size();
+    }
+    
+    text.clear();
+    text.shrink_to_fit();
+    resetCounts();
+    textIsComplete = false;
+    mappedSource = filename;
+    processRange(file.data(), file.size(), &file);
+    pendingTail.assign(trailingToken(file.data(), file.size()));
+    return true;
+#endif
+}
+
+// Load text from string
+void TextAnalyzer::loadFromString(const std::string& inputText) {
+    text = inputText;
+    processText();
+}
+
+// Count syllables in a word (simplified algorithm)
+int TextAnalyzer::countSyllables(std::string_view word) {
+    if (word.empty()) return 0;
+    
+    int syllables = 0;
+    bool prevWasVowel = false;
+    
+    for (size_t i = 0; i < word.length(); i++) {
+        bool currentIsVowel = isVowel(word[i]);
+        if (currentIsVowel && !prevWasVowel) {
+            syllables++;
+        }
+        prevWasVowel = currentIsVowel;
+    }
+    
+    // Handle silent 'e'
+    if (word.length() > 1 && word.back() == 'e' && !isVowel(word[word.length()-2])) {
+        syllables--;
+    }
+    
+    return std::max(1, syllables); // Every word has at least 1 syllable
+}
+
+bool TextAnalyzer::isVowel(char c) {
+    char lower = std::tolower(c);
+    return (lower == 'a' || lower == 'e' || lower == 'i' || lower == 'o' || lower == 'u');
+}
+
+void TextAnalyzer::resetCounts() {
+    invalidateViews(); // The views point into the table's arena
+    snapshot.reset();
+    wordFrequency.clear();
+    ngrams.clear();
+    if (heavyHitters) heavyHitters->clear();
+    pendingTail.clear();
+    totalWords = 0;
+    totalSentences = 0;
+    totalSyllables = 0;
+}
+
+// Count every word of a byte range into the analyzer's own totals
+void TextAnalyzer::processBuffer(const char* data, size_t length) {
+    if (heavyHitters) {
+        totalSentences += forEachWord(data, length, scratch, [this](std::string_view word) {
+            heavyHitters->add(word);
+            totalWords++;
+            totalSyllables += countSyllables(word);
+        });
+        return;
+    }
+    totalSentences += forEachWord(data, length, scratch, [this](std::string_view word) {
+        WordTable::Entry& entry = wordFrequency.entry(word);
+        if (entry.count++ == 0) tagNewWord(entry, word);
+        totalWords++;
+        if (countNGrams) ngrams.push(entry.id);
+    });
+}
+
+// Count a byte range, splitting it at whitespace across worker threads when
+// enabled. Each worker fills its own shard, and the shards are merged at the
+// end, so the totals match the serial path exactly. When the range comes from
+// a mapping, pages are released as soon as they have been counted, a small
+// window at a time per worker, so the mapped pages resident at once stay at a
+// few MB per thread however large the file.
+void TextAnalyzer::processRange(const char* data, size_t length, MappedFile* mapping) {
+    const size_t windowSize = 2 << 20;
+    const size_t minBytesPerThread = 1 << 20;
+    invalidateViews();
+    size_t workers = std::min<size_t>(threadCount, length / minBytesPerThread);
+    
+    PhaseTimer timer(counters.process);
+    counters.process.bytes += length;
+    uint64_t wordsBefore = totalWords;
+    size_t idsBefore = wordFrequency.idCount();
+    uint64_t rehashesBefore = wordFrequency.rehashes();
+    auto countWork = [&]() {
+        counters.tokens += totalWords - wordsBefore;
+        counters.uniqueInserts += wordFrequency.idCount() - idsBefore;
+        counters.rehashes += wordFrequency.rehashes() - rehashesBefore;
+    };
+    
+    if (workers <= 1) {
+        forEachWindow(data, 0, length, windowSize, [&](size_t offset, size_t bytes) {
+            processBuffer(data + offset, bytes);
+            if (mapping) mapping->release(offset, bytes);
+        });
+        countWork();
+        return;
+    }
+    
+    // Slice boundaries, each moved forward to the next whitespace byte
+    std::vector<size_t> bounds(workers + 1, length);
+    bounds[0] = 0;
+    for (size_t i = 1; i < workers; i++) {
+        size_t cut = std::max(bounds[i - 1], length / workers * i);
+        while (cut < length && !isSpaceByte(data[cut])) cut++;
+        bounds[i] = cut;
+    }
+    
+    std::vector<WordShard> shards(workers);
+    std::vector<std::thread> pool;
+    bool withNGrams = countNGrams && !heavyHitters;
+    for (size_t i = 0; i < workers; i++) {
+        if (heavyHitters) {
+            shards[i].approx.reset(new HeavyHitters(approxTopK, approxWidth, approxDepth));
+        }
+        pool.emplace_back([&, i]() {
+            WordShard& shard = shards[i];
+            forEachWindow(data, bounds[i], bounds[i + 1], windowSize, [&](size_t offset, size_t bytes) {
+                shard.sentences += forEachWord(data + offset, bytes, shard.scratch,
+                    [this, &shard, withNGrams](std::string_view word) {
+                        if (shard.approx) {
+                            shard.approx->add(word);
+                            shard.syllables += countSyllables(word);
+                        } else {
+                            WordTable::Entry& entry = shard.frequency.entry(word);
+                            if (entry.count++ == 0) tagNewWord(entry, word);
+                            if (withNGrams) shard.ngrams.push(entry.id);
+                        }
+                        shard.words++;
+                    });
+                if (mapping) mapping->release(offset, bytes);
+            });
+        });
+    }
+    for (auto& worker : pool) worker.join();
+    
+    // Merge in slice order so phrases crossing a cut are stitched correctly
+    std::vector<uint32_t> idMap;
+    for (auto& shard : shards) {
+        if (shard.approx) heavyHitters->merge(*shard.approx);
+        idMap.assign(shard.frequency.idCount(), 0);
+        shard.frequency.forEach([this, &idMap](const WordTable::Entry& entry) {
+            WordTable::Entry& merged = wordFrequency.entry(entry.word());
+            if (merged.count == 0) {
+                merged.syllables = entry.syllables;
+                merged.stopWord = entry.stopWord;
+            }
+            merged.count += entry.count;
+            idMap[entry.id] = merged.id;
+        });
+        if (withNGrams) ngrams.append(shard.ngrams, idMap);
+        totalWords += shard.words;
+        totalSentences += shard.sentences;
+        totalSyllables += shard.syllables;
+        counters.rehashes += shard.frequency.rehashes();
+    }
+    countWork();
+}
+
+// Process the loaded text
+void TextAnalyzer::processText() {
+    resetCounts();
+    textIsComplete = true;
+    mappedSource.clear();
+    processRange(text.data(), text.size());
+    pendingTail.assign(trailingToken(text.data(), text.size()));
+}
+
+// Count only the new bytes. If the previous input ended inside a word and the
+// new data continues it, that word's count is taken back and the joined word
+// is counted instead. Sentences are counted per terminator, so a sentence that
+// spans the boundary needs no special handling.
+void TextAnalyzer::appendBuffer(const char* data, size_t length) {
+    if (length == 0) return;
+    thawSnapshot();
+    invalidateViews();
+    
+    size_t head = 0;
+    if (!pendingTail.empty() && !isSpaceByte(data[0])) {
+        while (head < length && !isSpaceByte(data[head])) head++;
+        
+        totalSentences -= forEachWord(pendingTail.data(), pendingTail.size(), scratch,
+            [this](std::string_view word) {
+                if (heavyHitters) {
+                    heavyHitters->undo(word);
+                    totalSyllables -= countSyllables(word);
+                } else {
+                    // Take back the stats too, so tokens keeps matching totalWords
+                    size_t wordsBefore = wordFrequency.size();
+                    wordFrequency.subtract(word, 1);
+                    if (wordFrequency.size() < wordsBefore && counters.uniqueInserts > 0) counters.uniqueInserts--;
+                    if (countNGrams) ngrams.popLast();
+                }
+                totalWords--;
+                if (counters.tokens > 0) counters.tokens--;
+            });
+        pendingTail.append(data, head);
+        processRange(pendingTail.data(), pendingTail.size()); // Timed and counted like any other input
+        if (head == length) return; // Still inside the same word
+    }
+    
+    processRange(data + head, length - head);
+    pendingTail.assign(trailingToken(data + head, length - head));
+}
+
+void TextAnalyzer::appendText(const std::string& moreText) {
+    mappedSource.clear(); // The mapped file alone no longer covers the counts
+    text += moreText;
+    appendBuffer(moreText.data(), moreText.size());
+}
+
+bool TextAnalyzer::appendFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    
+    // Read straight onto the end of the held text, then count just that part
+    mappedSource.clear();
+    size_t oldSize = text.size();
+    {
+        PhaseTimer timer(counters.load);
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        text.resize(oldSize + (size > 0 ? static_cast<size_t>(size) : 0));
+        file.read(&text[oldSize], text.size() - oldSize);
+        text.resize(oldSize + static_cast<size_t>(file.gcount()));
+        counters.load.bytes += text.size() - oldSize;
+    }
+    
+    appendBuffer(text.data() + oldSize, text.size() - oldSize);
+    return true;
+}
+
+bool TextAnalyzer::loadFromStream(std::FILE* input, size_t chunkBytes) {
+    if (!input) {
+        std::cerr << "Error: No input stream" << std::endl;
+        return false;
+    }
+    
+    text.clear();
+    text.shrink_to_fit();
+    resetCounts();
+    textIsComplete = false;
+    mappedSource.clear();
+    
+    // A word cut at the chunk edge is not counted yet: its raw bytes are
+    // carried into the next chunk and the word is counted once, when it ends
+    // or at the end of the input. A word spanning many chunks so costs time
+    // and memory linear in its length.
+    std::vector<char> chunk(std::max<size_t>(chunkBytes, 1));
+    std::string carry;
+    while (true) {
+        size_t bytes;
+        {
+            PhaseTimer timer(counters.load);
+            bytes = std::fread(chunk.data(), 1, chunk.size(), input);
+            counters.load.bytes += bytes;
+        }
+        if (bytes == 0) break;
+        
+        size_t head = 0;
+        if (!carry.empty()) {
+            while (head < bytes && !isSpaceByte(chunk[head])) head++;
+            carry.append(chunk.data(), head);
+            if (head == bytes) continue; // Still inside the same word
+            processRange(carry.data(), carry.size());
+            carry.clear();
+        }
+        std::string_view tail = trailingToken(chunk.data() + head, bytes - head);
+        processRange(chunk.data() + head, bytes - head - tail.size());
+        carry.assign(tail);
+    }
+    
+    // A later append may still continue the last word
+    if (!carry.empty()) processRange(carry.data(), carry.size());
+    pendingTail = std::move(carry);
+    
+    if (std::ferror(input)) {
+        std::cerr << "Error: Failed reading input stream" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Syllables in the whole text. Each distinct word's syllables are counted once
+// when it enters the table, so the total is the sum of count x syllables and
+// is only recomputed after the counts change.
+uint64_t TextAnalyzer::syllableCount() {
+    if (!heavyHitters && !snapshot && !syllablesValid) {
+        totalSyllables = 0;
+        wordFrequency.forEach([this](const WordTable::Entry& entry) {
+            totalSyllables += entry.count * entry.syllables;
+        });
+        syllablesValid = true;
+    }
+    return totalSyllables;
+}
+
+// Sentences for the averages; text without a terminator counts as one sentence
+uint64_t TextAnalyzer::sentenceCount() const {
+    return std::max<uint64_t>(1, totalSentences); // Avoid division by zero
+}
+
+// Display basic statistics
+void TextAnalyzer::displayBasicStats() {
+    std::cout << "\n=== TEXT ANALYSIS RESULTS ===\n";
+    std::cout << "Total Words: " << totalWords << std::endl;
+    std::cout << "Total Sentences: " << sentenceCount() << std::endl;
+    std::cout << "Total Syllables: " << syllableCount() << std::endl;
+    if (heavyHitters) {
+        std::cout << "Unique Words: not tracked in approximate mode" << std::endl;
+    } else {
+        std::cout << "Unique Words: " << uniqueWordCount() << std::endl;
+    }
+    std::cout << "Average Words per Sentence: " << std::fixed << std::setprecision(2) 
+              << (double)totalWords / sentenceCount() << std::endl;
+    std::cout << "Average Syllables per Word: " << std::fixed << std::setprecision(2)
+              << (double)syllableCount() / totalWords << std::endl;
+}
+
+// Flesch-Kincaid Grade Level without printing it
+double TextAnalyzer::readingLevel() {
+    if (totalWords == 0) return 0.0;
+    
+    double avgWordsPerSentence = (double)totalWords / sentenceCount();
+    double avgSyllablesPerWord = (double)syllableCount() / totalWords;
+    
+    // Flesch-Kincaid Grade Level formula
+    return 0.39 * avgWordsPerSentence + 11.8 * avgSyllablesPerWord - 15.59;
+}
+
+// Calculate Flesch-Kincaid Reading Level
+double TextAnalyzer::calculateReadingLevel() {
+    if (totalWords == 0) return 0.0;
+    
+    double readingLevel = this->readingLevel();
+    
+    std::cout << "Reading Level (Flesch-Kincaid): " << std::fixed << std::setprecision(1) 
+              << readingLevel << " (Grade " << (int)readingLevel << ")" << std::endl;
+    
+    return readingLevel;
+}
+
+ReadabilityTimeline::ReadabilityTimeline(size_t window, bool bySentences, size_t step)
+    : window(std::max<size_t>(window, 1)), bySentences(bySentences), step(std::max<size_t>(step, 1)) {}
+
+// Add a unit to the window, dropping the oldest once the window is full
+void ReadabilityTimeline::push(const Unit& unit) {
+    if (ring.size() < window) {
+        ring.push_back(unit);
+    } else {
+        Unit& old = ring[next];
+        sums.words -= old.words;
+        sums.syllables -= old.syllables;
+        sums.terminators -= old.terminators;
+        old = unit;
+    }
+    next = next + 1 == window ? 0 : next + 1;
+    sums.words += unit.words;
+    sums.syllables += unit.syllables;
+    sums.terminators += unit.terminators;
+}
+
+// Word mode keeps one unit per word, holding the terminators read since the
+// previous word, so punctuation before the first word counts as well. Sentence
+// mode keeps one unit per terminator, like the whole-text counts.
+void ReadabilityTimeline::addWord(std::string_view word) {
+    uint64_t terminators = state.sentences - attributed;
+    attributed = state.sentences;
+    words++;
+    uint64_t syllables = TextAnalyzer::countSyllables(word);
+    if (bySentences) {
+        sentence.words++;
+        sentence.syllables += syllables;
+        for (; terminators > 0; terminators--) endSentence();
+    } else {
+        push({1, syllables, terminators});
+        sentences += terminators;
+        if (words % step == 0) record();
+    }
+}
+
+void ReadabilityTimeline::endSentence() {
+    sentence.terminators = 1;
+    push(sentence);
+    sentence = Unit();
+    if (++sentences % step == 0) record();
+}
+
+void ReadabilityTimeline::record() {
+    recorded.push_back({words, sentences, grade()});
+}
+
+// Scanned byte by byte: the vector paths count a whole block's terminators
+// before its words, which would hand them to the wrong word
+void ReadabilityTimeline::feed(const char* data, size_t length) {
+    auto onWord = [this](std::string_view word) { addWord(word); };
+    scanScalar(data, data + length, state, scratch, onWord);
+    state.detach(scratch); // The caller may reuse the buffer
+}
+
+void ReadabilityTimeline::finish() {
+    auto onWord = [this](std::string_view word) { addWord(word); };
+    if (state.inToken) endToken(state, scratch, onWord);
+    
+    // Punctuation after the last word ends its sentence
+    uint64_t terminators = state.sentences - attributed;
+    attributed = state.sentences;
+    if (bySentences) {
+        for (; terminators > 0; terminators--) endSentence();
+    } else if (terminators > 0) {
+        if (!ring.empty()) {
+            size_t last = next == 0 ? ring.size() - 1 : next - 1;
+            ring[last].terminators += terminators;
+            sums.terminators += terminators;
+        }
+        sentences += terminators;
+    }
+}
+
+// Same formula as calculateReadingLevel, over the window only
+double ReadabilityTimeline::grade() const {
+    if (sums.words == 0) return 0.0;
+    double sentencesInWindow = std::max<uint64_t>(1, sums.terminators);
+    return 0.39 * sums.words / sentencesInWindow + 11.8 * sums.syllables / sums.words - 15.59;
+}
+
+std::vector<ReadabilityPoint> ReadabilityTimeline::takePoints() {
+    std::vector<ReadabilityPoint> points;
+    points.swap(recorded);
+    return points;
+}
+
+std::vector<ReadabilityPoint> TextAnalyzer::readabilityTimeline(size_t window, bool bySentences, size_t step) {
+    MappedFile file;
+    const char* data;
+    size_t length;
+    if (!sourceText(file, data, length)) {
+        std::cerr << "Error: The timeline needs the text, which was not kept" << std::endl;
+        return {};
+    }
+    ReadabilityTimeline timeline(window, bySentences, step);
+    timeline.feed(data, length);
+    timeline.finish();
+    return timeline.takePoints();
+}
+
+// Print about 20 evenly spaced points of the timeline
+void TextAnalyzer::displayReadabilityTimeline(size_t window, bool bySentences) {
+    const uint64_t rows = 20;
+    uint64_t units = bySentences ? totalSentences : totalWords;
+    auto points = readabilityTimeline(window, bySentences, std::max<uint64_t>(1, units / rows));
+    
+    std::cout << "\n=== READING LEVEL OVER LAST " << window << (bySentences ? " SENTENCES" : " WORDS") << " ===\n";
+    for (const auto& point : points) {
+        std::cout << "Word " << std::setw(10) << point.word << "  Sentence " << std::setw(8) << point.sentence
+                  << "  Grade " << std::fixed << std::setprecision(1) << point.grade << "\n";
+    }
+}
+
+// Drop everything derived from the counts
+void TextAnalyzer::invalidateViews() {
+    syllablesValid = false;
+    if (indexValid) index.clear();
+    indexValid = false;
+    ranked.clear();
+    topCache.clear();
+    bottomCache.clear();
+    rankedValid = topValid = bottomValid = false;
+}
+
+// Every word sorted most common first, built once per change of the counts
+const std::vector<RankedWord>& TextAnalyzer::rankedWords() {
+    if (filterStopWords) thawSnapshot(); // The tags live in the table
+    if (!rankedValid && snapshot) {
+        // Already in report order; only the views need to be made
+        PhaseTimer timer(counters.report);
+        ranked.clear();
+        ranked.reserve(snapshotCount);
+        for (size_t i = 0; i < snapshotCount; i++) ranked.push_back(snapshotWord(i));
+        rankedValid = true;
+    }
+    if (!rankedValid) {
+        PhaseTimer timer(counters.report);
+        ranked.clear();
+        ranked.reserve(wordFrequency.size());
+        wordFrequency.forEach([this](const WordTable::Entry& entry) {
+            if (!(filterStopWords && entry.stopWord)) ranked.push_back({entry.word(), entry.count});
+        });
+        std::sort(ranked.begin(), ranked.end(), moreCommon);
+        rankedValid = true;
+    }
+    return ranked;
+}
+
+// Pick the `count` most (or least) common words with a bounded heap, which
+// costs O(n log count) instead of sorting the whole table
+std::vector<RankedWord> TextAnalyzer::selectWords(size_t count, bool mostCommon) const {
+    auto better = mostCommon ? moreCommon : lessCommon;
+    std::vector<RankedWord> heap; // Worst kept word on top
+    if (count == 0) return heap;
+    heap.reserve(count);
+    
+    wordFrequency.forEach([&](const WordTable::Entry& entry) {
+        if (filterStopWords && entry.stopWord) return;
+        RankedWord candidate{entry.word(), entry.count};
+        if (heap.size() < count) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(candidate, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    });
+    std::sort_heap(heap.begin(), heap.end(), better);
+    return heap;
+}
+
+// The `count` most common words, reusing the full ranking or an earlier
+// selection of at least that many words when one is still valid
+std::vector<RankedWord> TextAnalyzer::topWords(size_t count) {
+    if (filterStopWords) thawSnapshot();
+    count = std::min(count, uniqueWordCount());
+    if (snapshot && !rankedValid) {
+        std::vector<RankedWord> words;
+        for (size_t i = 0; i < count; i++) words.push_back(snapshotWord(i));
+        return words;
+    }
+    if (rankedValid) {
+        return std::vector<RankedWord>(ranked.begin(), ranked.begin() + std::min(count, ranked.size()));
+    }
+    if (!topValid || topCache.size() < count) {
+        PhaseTimer timer(counters.report);
+        topCache = selectWords(count, true);
+        topValid = true;
+    }
+    // Fewer than count are left when stop words are filtered out
+    return std::vector<RankedWord>(topCache.begin(), topCache.begin() + std::min(count, topCache.size()));
+}
+
+// The `count` least common words, cached the same way as topWords
+std::vector<RankedWord> TextAnalyzer::bottomWords(size_t count) {
+    if (filterStopWords) thawSnapshot();
+    count = std::min(count, uniqueWordCount());
+    if (snapshot) {
+        // The array runs from high to low counts with ties alphabetical, so
+        // take runs of equal count from the back, each one front to back
+        PhaseTimer timer(counters.report);
+        std::vector<RankedWord> words;
+        size_t runEnd = snapshotCount;
+        while (words.size() < count) {
+            uint64_t runCount = snapshotEntries[runEnd - 1].count;
+            const SnapshotEntry* runStart = std::partition_point(snapshotEntries, snapshotEntries + runEnd,
+                [runCount](const SnapshotEntry& e) { return e.count > runCount; });
+            for (size_t i = runStart - snapshotEntries; i < runEnd && words.size() < count; i++) {
+                words.push_back(snapshotWord(i));
+            }
+            runEnd = runStart - snapshotEntries;
+        }
+        return words;
+    }
+    if (!bottomValid || bottomCache.size() < count) {
+        PhaseTimer timer(counters.report);
+        bottomCache = selectWords(count, false);
+        bottomValid = true;
+    }
+    return std::vector<RankedWord>(bottomCache.begin(), bottomCache.begin() + std::min(count, bottomCache.size()));
+}
+
+size_t TextAnalyzer::uniqueWordCount() const {
+    return snapshot ? snapshotCount : wordFrequency.size();
+}
+
+// Word at a rank of the loaded snapshot; bad pool references read as empty
+RankedWord TextAnalyzer::snapshotWord(size_t rank) const {
+    const SnapshotEntry& entry = snapshotEntries[rank];
+    if (entry.offset > snapshotPoolBytes || entry.length > snapshotPoolBytes - entry.offset) {
+        return {std::string_view(), entry.count};
+    }
+    return {std::string_view(snapshotPool + entry.offset, entry.length), entry.count};
+}
+
+// Copy a loaded snapshot into the word table so more text can be counted on top
+void TextAnalyzer::thawSnapshot() {
+    if (!snapshot) return;
+    invalidateViews();
+    for (size_t i = 0; i < snapshotCount; i++) {
+        WordTable::Entry& entry = wordFrequency.entry(snapshotWord(i).word);
+        entry.count = snapshotEntries[i].count;
+        entry.syllables = snapshotEntries[i].syllables;
+        entry.stopWord = isStopWord(entry.word());
+    }
+    snapshot.reset();
+}
+
+bool TextAnalyzer::saveSnapshot(const std::string& filename) {
+    if (heavyHitters) {
+        std::cerr << "Error: Snapshots need exact counts, not approximate mode" << std::endl;
+        return false;
+    }
+    // Work from the table so the file being written is never one still mapped
+    thawSnapshot();
+    
+    // Stop words are saved too; filtering is a property of the views. The
+    // ranking is timed as report work, so it is done before the output timer.
+    bool filtering = filterStopWords;
+    setStopWordFiltering(false);
+    std::vector<RankedWord> words = rankedWords();
+    setStopWordFiltering(filtering);
+    
+    PhaseTimer timer(counters.output);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not create output file " << filename << std::endl;
+        return false;
+    }
+    
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.entrySize = sizeof(SnapshotEntry);
+    header.totalWords = totalWords;
+    header.totalSentences = totalSentences;
+    header.totalSyllables = syllableCount();
+    header.entryCount = words.size();
+    header.entriesOffset = sizeof(SnapshotHeader);
+    header.poolOffset = header.entriesOffset + words.size() * sizeof(SnapshotEntry);
+    
+    std::vector<SnapshotEntry> entries;
+    entries.reserve(words.size());
+    uint64_t poolBytes = 0;
+    for (const auto& word : words) {
+        const WordTable::Entry* source = wordFrequency.find(word.word);
+        entries.push_back({word.count, poolBytes, static_cast<uint32_t>(word.word.size()), source->syllables});
+        poolBytes += word.word.size();
+    }
+    header.poolBytes = poolBytes;
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+    for (const auto& word : words) file.write(word.word.data(), word.word.size());
+    counters.output.bytes += header.poolOffset + poolBytes;
+    
+    if (!file) {
+        std::cerr << "Error: Failed writing snapshot " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Snapshot saved to " << filename << std::endl;
+    return true;
+}
+
+// Map a snapshot and serve reports straight from it. Only the header is
+// checked up front; entries are bounds-checked as they are read.
+bool TextAnalyzer::loadSnapshot(const std::string& filename) {
+    PhaseTimer timer(counters.load);
+    std::unique_ptr<MappedFile> file(new MappedFile());
+    if (!file->open(filename)) {
+        std::cerr << "Error: Could not open snapshot " << filename << std::endl;
+        return false;
+    }
+    counters.load.bytes += file->size();
+    
+    const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(file->data());
+    uint64_t size = file->size();
+    if (size < sizeof(SnapshotHeader) ||
+        std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION || header->entrySize != sizeof(SnapshotEntry) ||
+        header->entriesOffset % alignof(SnapshotEntry) != 0 ||
+        header->entriesOffset > size ||
+        header->entryCount > (size - header->entriesOffset) / sizeof(SnapshotEntry) ||
+        header->poolOffset > size || header->poolBytes > size - header->poolOffset) {
+        std::cerr << "Error: " << filename << " is not a valid snapshot" << std::endl;
+        return false;
+    }
+    
+    text.clear();
+    text.shrink_to_fit();
+    resetCounts();
+    textIsComplete = false;
+    mappedSource.clear();
+    totalWords = header->totalWords;
+    totalSentences = header->totalSentences;
+    totalSyllables = header->totalSyllables;
+    syllablesValid = true;
+    snapshotEntries = reinterpret_cast<const SnapshotEntry*>(file->data() + header->entriesOffset);
+    snapshotPool = file->data() + header->poolOffset;
+    snapshotCount = static_cast<size_t>(header->entryCount);
+    snapshotPoolBytes = static_cast<size_t>(header->poolBytes);
+    snapshot = std::move(file);
+    return true;
+}
+
+// Explain how far approximate counts can be off
+void TextAnalyzer::printErrorBound(std::ostream& out) const {
+    out << "Estimates overcount by at most " << std::fixed << std::setprecision(0)
+        << heavyHitters->errorBound() << " with " << std::setprecision(1)
+        << heavyHitters->confidence() * 100 << "% confidence\n";
+}
+
+// Heaviest words of the approximate summary, less any stop words
+std::vector<HeavyHitters::Estimate> TextAnalyzer::approxTop(size_t count) {
+    PhaseTimer timer(counters.report);
+    if (!filterStopWords) return heavyHitters->top(count);
+    std::vector<HeavyHitters::Estimate> estimates = heavyHitters->top(approxTopK);
+    estimates.erase(std::remove_if(estimates.begin(), estimates.end(),
+        [this](const HeavyHitters::Estimate& estimate) { return isStopWord(estimate.word); }),
+        estimates.end());
+    if (estimates.size() > count) estimates.resize(count);
+    return estimates;
+}
+
+// Display word frequency
+void TextAnalyzer::displayWordFrequency(int topN) {
+    if (heavyHitters) {
+        std::cout << "\n=== TOP " << topN << " WORD FREQUENCIES (APPROXIMATE) ===\n";
+        printErrorBound(std::cout);
+        for (const auto& entry : approxTop(std::max(0, topN))) {
+            std::cout << std::setw(15) << entry.word << ": " << entry.count
+                      << " (at least " << entry.guaranteed << ")" << std::endl;
+        }
+        return;
+    }
+    
+    auto wordVec = topWords(std::max(0, topN));
+    
+    std::cout << "\n=== TOP " << topN << " WORD FREQUENCIES ===\n";
+    for (const auto& entry : wordVec) {
+        std::cout << std::setw(15) << entry.word << ": " << entry.count << std::endl;
+    }
+}
+
+// Find most common words
+void TextAnalyzer::findMostCommonWords(int count) {
+    if (heavyHitters) {
+        auto estimates = approxTop(std::max(0, count));
+        std::cout << "\n=== " << count << " MOST COMMON WORDS (APPROXIMATE) ===\n";
+        printErrorBound(std::cout);
+        for (size_t i = 0; i < estimates.size(); i++) {
+            std::cout << (i+1) << ". " << estimates[i].word << " (about " << estimates[i].count
+                      << " times, at least " << estimates[i].guaranteed << ")\n";
+        }
+        return;
+    }
+    
+    auto wordVec = topWords(std::max(0, count));
+    
+    std::cout << "\n=== " << count << " MOST COMMON WORDS ===\n";
+    for (size_t i = 0; i < wordVec.size(); i++) {
+        std::cout << (i+1) << ". " << wordVec[i].word << " (" << wordVec[i].count << " times)\n";
+    }
+}
+
+// Find least common words
+void TextAnalyzer::findLeastCommonWords(int count) {
+    if (heavyHitters) {
+        // Rare words are exactly what the fixed-size summary forgets
+        std::cout << "\nLeast common words are not available in approximate mode\n";
+        return;
+    }
+    
+    auto wordVec = bottomWords(std::max(0, count));
+    
+    std::cout << "\n=== " << count << " LEAST COMMON WORDS ===\n";
+    for (size_t i = 0; i < wordVec.size(); i++) {
+        std::cout << (i+1) << ". " << wordVec[i].word << " (" << wordVec[i].count << " times)\n";
+    }
+}
+
+// Export results to file
+void TextAnalyzer::exportResults(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not create output file " << filename << std::endl;
+        return;
+    }
+    
+    writeReport(file);
+    file.close();
+    std::cout << "Results exported to " << filename << std::endl;
+}
+
+// The exported report, without any console output
+void TextAnalyzer::writeReport(std::ostream& file) {
+    // Rank everything first; that is timed as report work, and the output
+    // timer covers only the writing
+    const size_t reportedPhrases = 50;
+    double level = readingLevel();
+    std::vector<HeavyHitters::Estimate> estimates;
+    const std::vector<RankedWord>* words = nullptr;
+    if (heavyHitters) {
+        estimates = approxTop(approxTopK);
+    } else {
+        words = &rankedWords();
+    }
+    std::vector<std::pair<std::string, uint64_t>> bigrams, trigrams;
+    if (phrasesAvailable()) {
+        PhaseTimer timer(counters.report);
+        bigrams = topPhrases(ngrams.bigrams, reportedPhrases);
+        trigrams = topPhrases(ngrams.trigrams, reportedPhrases);
+    }
+    
+    PhaseTimer timer(counters.output);
+    std::streampos start = file.tellp();
+    file << "TEXT ANALYSIS REPORT\n";
+    file << "===================\n\n";
+    file << "Total Words: " << totalWords << "\n";
+    file << "Total Sentences: " << sentenceCount() << "\n";
+    if (heavyHitters) {
+        file << "Unique Words: not tracked in approximate mode\n";
+    } else {
+        file << "Unique Words: " << uniqueWordCount() << "\n";
+    }
+    file << "Reading Level: " << level << "\n\n";
+    
+    if (heavyHitters) {
+        file << "WORD FREQUENCY (APPROXIMATE, word,estimate,lower bound):\n";
+        printErrorBound(file);
+        for (const auto& entry : estimates) {
+            file << entry.word << "," << entry.count << "," << entry.guaranteed << "\n";
+        }
+    } else {
+        file << "WORD FREQUENCY:\n";
+        for (const auto& entry : *words) {
+            file << entry.word << "," << entry.count << "\n";
+        }
+    }
+    
+    if (phrasesAvailable()) {
+        file << "\nTOP BIGRAMS:\n";
+        for (const auto& phrase : bigrams) {
+            file << phrase.first << "," << phrase.second << "\n";
+        }
+        file << "\nTOP TRIGRAMS:\n";
+        for (const auto& phrase : trigrams) {
+            file << phrase.first << "," << phrase.second << "\n";
+        }
+    }
+    if (start != std::streampos(-1)) counters.output.bytes += static_cast<uint64_t>(file.tellp() - start);
+}
+
+void TextAnalyzer::displayStats() const {
+    auto show = [](const char* name, const PhaseStats& phase) {
+        std::cout << std::setw(10) << std::left << name << std::right
+                  << std::setw(8) << phase.calls << " calls"
+                  << std::setw(12) << std::fixed << std::setprecision(3) << phase.seconds() * 1000 << " ms";
+        if (phase.bytes) {
+            std::cout << std::setw(14) << phase.bytes << " bytes";
+            if (phase.nanoseconds) {
+                std::cout << std::setw(10) << std::setprecision(1) << phase.bytes / phase.seconds() / (1 << 20) << " MB/s";
+            }
+        }
+        std::cout << "\n";
+    };
+    
+    std::cout << "\n=== PERFORMANCE STATS ===\n";
+    show("Load", counters.load);
+    show("Process", counters.process);
+    show("Report", counters.report);
+    show("Output", counters.output);
+    std::cout << "Tokens: " << counters.tokens << "\n";
+    std::cout << "Unique inserts: " << counters.uniqueInserts << "\n";
+    std::cout << "Table rehashes: " << counters.rehashes << "\n";
+}
+
+void TextAnalyzer::writeStats(std::ostream& out) const {
+    auto phase = [&out](const char* name, const PhaseStats& p) {
+        out << "\"" << name << "\":{\"calls\":" << p.calls << ",\"ns\":" << p.nanoseconds
+            << ",\"bytes\":" << p.bytes << "},";
+    };
+    out << "{";
+    phase("load", counters.load);
+    phase("process", counters.process);
+    phase("report", counters.report);
+    phase("output", counters.output);
+    out << "\"tokens\":" << counters.tokens << ",\"unique_inserts\":" << counters.uniqueInserts
+        << ",\"rehashes\":" << counters.rehashes << "}\n";
+}
+
+std::string TextAnalyzer::phraseText(uint64_t key) const {
+    std::string phrase(wordFrequency.wordById(static_cast<uint32_t>(key >> 32)));
+    phrase += ' ';
+    phrase += wordFrequency.wordById(static_cast<uint32_t>(key));
+    return phrase;
+}
+
+std::string TextAnalyzer::phraseText(const TrigramKey& key) const {
+    std::string phrase = phraseText(key.high);
+    phrase += ' ';
+    phrase += wordFrequency.wordById(static_cast<uint32_t>(key.low));
+    return phrase;
+}
+
+// Most frequent n-grams by bounded-heap selection, like selectWords. Only the
+// winners (and ties) are ever turned back into text.
+template <typename Key>
+std::vector<std::pair<std::string, uint64_t>> TextAnalyzer::topPhrases(const NGramTable<Key>& table, size_t count) const {
+    using Item = std::pair<Key, uint64_t>;
+    auto better = [this](const Item& a, const Item& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return phraseText(a.first) < phraseText(b.first);
+    };
+    std::vector<Item> heap;
+    count = std::min(count, table.size());
+    if (count > 0) {
+        heap.reserve(count);
+        table.forEach([&](const Key& key, uint64_t n) {
+            Item candidate(key, n);
+            if (heap.size() < count) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end(), better);
+            } else if (n >= heap.front().second && better(candidate, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+        });
+        std::sort_heap(heap.begin(), heap.end(), better);
+    }
+    
+    std::vector<std::pair<std::string, uint64_t>> phrases;
+    for (const Item& item : heap) phrases.emplace_back(phraseText(item.first), item.second);
+    return phrases;
+}
+
+bool TextAnalyzer::phrasesAvailable() const {
+    return countNGrams && !heavyHitters && !snapshot;
+}
+
+// Find most common bigrams (length 2) or trigrams (length 3)
+void TextAnalyzer::findMostCommonPhrases(int length, int count) {
+    if (!phrasesAvailable()) {
+        std::cout << "\nPhrase counts are not available (start with --ngrams to count them)\n";
+        return;
+    }
+    
+    size_t wanted = static_cast<size_t>(std::max(0, count));
+    auto phrases = length == 3 ? topPhrases(ngrams.trigrams, wanted) : topPhrases(ngrams.bigrams, wanted);
+    
+    std::cout << "\n=== " << count << " MOST COMMON " << (length == 3 ? "TRIGRAMS" : "BIGRAMS") << " ===\n";
+    for (size_t i = 0; i < phrases.size(); i++) {
+        std::cout << (i+1) << ". " << phrases[i].first << " (" << phrases[i].second << " times)\n";
+    }
+}
+
+// The counted text, held in memory or mapped again from its one source file
+bool TextAnalyzer::sourceText(MappedFile& file, const char*& data, size_t& length) const {
+    if (textIsComplete) {
+        data = text.data();
+        length = text.size();
+        return true;
+    }
+    if (mappedSource.empty() || !file.open(mappedSource)) return false;
+    data = file.data();
+    length = file.size();
+    return true;
+}
 
-// Load text from file
-bool TextAnalyzer::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
+// Tokenize the text once more and record where every word occurs
+bool TextAnalyzer::buildIndex() {
+    if (indexValid) return true;
+    if (heavyHitters) {
+        std::cerr << "Error: The index needs exact counts, not approximate mode" << std::endl;
         return false;
     }
     
-    std::string line;
-    text.clear();
-    while (std::getline(file, line)) {
-        text += line + " ";
+    MappedFile file;
+    const char* data;
+    size_t length;
+    if (!sourceText(file, data, length)) {
+        std::cerr << "Error: The index needs the text, which was not kept" << std::endl;
+        return false;
     }
-    file.close();
     
-    processText();
+    index.clear();
+    forEachWord(data, length, scratch, [this](std::string_view word) {
+        const WordTable::Entry* entry = wordFrequency.find(word);
+        if (entry) index.add(entry->id);
+        else index.skip(); // The mapped file changed since it was counted
+    });
+    indexValid = true;
     return true;
 }
 
-// Load text from string
-void TextAnalyzer::loadFromString(const std::string& inputText) {
-    text = inputText;
-    processText();
+// Clean a query the same way the text was cleaned
+std::vector<std::string> TextAnalyzer::queryWords(const std::string& query) {
+    std::vector<std::string> words;
+    forEachWord(query.data(), query.size(), scratch, [&words](std::string_view word) {
+        words.emplace_back(word);
+    });
+    return words;
 }
 
-// Convert string to lowercase
-std::string TextAnalyzer::toLowerCase(const std::string& word) {
-    std::string result = word;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
+std::vector<uint64_t> TextAnalyzer::occurrences(const std::string& word) {
+    return findPhrase(word);
 }
 
-// Remove punctuation and clean word
-std::string TextAnalyzer::cleanWord(const std::string& word) {
-    std::string cleaned;
-    for (char c : word) {
-        if (std::isalnum(c)) {
-            cleaned += c;
+// Positions where the phrase starts. The lists are intersected rarest word
+// first, each shifted back by its offset in the phrase.
+std::vector<uint64_t> TextAnalyzer::findPhrase(const std::string& phrase) {
+    std::vector<uint64_t> matches;
+    std::vector<std::string> words = queryWords(phrase);
+    if (words.empty() || !buildIndex()) return matches;
+    
+    std::vector<std::pair<uint32_t, size_t>> terms; // (word ID, offset in phrase)
+    for (size_t i = 0; i < words.size(); i++) {
+        const WordTable::Entry* entry = wordFrequency.find(words[i]);
+        if (!entry) return matches;
+        terms.emplace_back(entry->id, i);
+    }
+    std::sort(terms.begin(), terms.end(), [this](const auto& a, const auto& b) {
+        return index.frequency(a.first) < index.frequency(b.first);
+    });
+    
+    // Leapfrog over the lists, rarest first: each cursor seeks to where the
+    // current candidate start needs it, and one that lands further on moves
+    // the candidate forward. Common words' lists are skipped through by
+    // block, never decoded in full.
+    std::vector<PositionalIndex::Cursor> cursors;
+    for (const auto& term : terms) cursors.push_back(index.cursor(term.first));
+    if (terms.size() == 1) {
+        matches.reserve(index.frequency(terms[0].first));
+        for (auto& cursor = cursors[0]; !cursor.done(); cursor.next()) matches.push_back(cursor.position());
+        return matches;
+    }
+    uint64_t start = 0;
+    while (true) {
+        bool agreed = true;
+        for (size_t t = 0; t < terms.size(); t++) {
+            cursors[t].seek(start + terms[t].second);
+            if (cursors[t].done()) return matches;
+            uint64_t candidate = cursors[t].position() - terms[t].second;
+            if (candidate != start) {
+                start = candidate;
+                agreed = false;
+                break;
+            }
         }
+        if (agreed) matches.push_back(start++);
     }
-    return toLowerCase(cleaned);
 }
 
-// Count syllables in a word (simplified algorithm)
-int TextAnalyzer::countSyllables(const std::string& word) {
-    if (word.empty()) return 0;
+void TextAnalyzer::displayPhraseSearch(const std::string& phrase) {
+    auto started = std::chrono::steady_clock::now();
+    std::vector<uint64_t> matches = findPhrase(phrase);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
     
-    int syllables = 0;
-    bool prevWasVowel = false;
+    const size_t shown = 10;
+    std::cout << "\n\"" << phrase << "\" found " << matches.size() << " times ("
+              << elapsed.count() << " us)\n";
+    for (size_t i = 0; i < std::min(shown, matches.size()); i++) {
+        std::cout << "  at word " << matches[i] << "\n";
+    }
+    if (matches.size() > shown) std::cout << "  ...\n";
+}
+
+bool TextAnalyzer::merge(const TextAnalyzer& other) {
+    if (!heavyHitters != !other.heavyHitters) {
+        std::cerr << "Error: Cannot merge exact and approximate counts" << std::endl;
+        return false;
+    }
+    thawSnapshot();
+    invalidateViews();
+    pendingTail.clear(); // The texts are separate documents
+    textIsComplete = false;
+    mappedSource.clear();
     
-    for (size_t i = 0; i < word.length(); i++) {
-        bool currentIsVowel = isVowel(word[i]);
-        if (currentIsVowel && !prevWasVowel) {
-            syllables++;
+    if (heavyHitters) {
+        heavyHitters->merge(*other.heavyHitters);
+        totalSyllables += other.totalSyllables;
+    } else if (other.snapshot) {
+        for (size_t i = 0; i < other.snapshotCount; i++) {
+            WordTable::Entry& entry = wordFrequency.entry(other.snapshotWord(i).word);
+            entry.count += other.snapshotEntries[i].count;
+            entry.syllables = other.snapshotEntries[i].syllables;
+            entry.stopWord = isStopWord(entry.word());
+        }
+    } else {
+        std::vector<uint32_t> idMap(other.wordFrequency.idCount(), 0);
+        other.wordFrequency.forEach([this, &idMap](const WordTable::Entry& source) {
+            WordTable::Entry& entry = wordFrequency.entry(source.word());
+            entry.count += source.count;
+            entry.syllables = source.syllables;
+            entry.stopWord = isStopWord(entry.word());
+            idMap[source.id] = entry.id;
+        });
+        if (countNGrams && other.countNGrams) {
+            ngrams.historyLength = 0; // No phrase runs from one document into the next
+            ngrams.append(other.ngrams, idMap);
+        }
+    }
+    totalWords += other.totalWords;
+    totalSentences += other.totalSentences;
+    return true;
+}
+
+// Expand command-line inputs into a sorted list of files. An input may be a
+// file, a directory (searched recursively) or @list, a file naming one input
+// per line. Returns false, after a message, when nothing usable was named.
+bool collectInputs(const std::vector<std::string>& arguments, std::vector<std::filesystem::path>& files) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> inputs;
+    for (const auto& arg : arguments) {
+        if (!arg.empty() && arg[0] == '@') {
+            std::ifstream list(arg.substr(1));
+            if (!list.is_open()) {
+                std::cerr << "Error: Could not open file list " << arg.substr(1) << std::endl;
+                return false;
+            }
+            std::string line;
+            while (std::getline(list, line)) {
+                if (!line.empty()) inputs.push_back(line);
+            }
+        } else {
+            inputs.push_back(arg);
         }
-        prevWasVowel = currentIsVowel;
     }
     
-    // Handle silent 'e'
-    if (word.length() > 1 && word.back() == 'e' && !isVowel(word[word.length()-2])) {
-        syllables--;
+    std::error_code error;
+    for (const auto& input : inputs) {
+        if (fs::is_directory(input, error)) {
+            for (const auto& item : fs::recursive_directory_iterator(input, error)) {
+                if (item.is_regular_file(error)) files.push_back(item.path());
+            }
+        } else {
+            files.push_back(input);
+        }
     }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cerr << "Error: No input files" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// MinHash signatures over shingles of consecutive word IDs. Each slot keeps
+// the smallest value of one hash function over a document's shingles, and
+// the share of slots two signatures agree on estimates the Jaccard
+// similarity of their shingle sets. Slot i hashes with (x * a_i + b_i) >> 32
+// over the mixed shingle key, a cheap multiply-shift family.
+class MinHasher {
+public:
+    static constexpr size_t SIZE = 64;
+    using Signature = std::array<uint32_t, SIZE>;
     
-    return std::max(1, syllables); // Every word has at least 1 syllable
+    explicit MinHasher(size_t shingleWords = 3, uint64_t seed = 0x9E3779B97F4A7C15ull);
+    
+    // Feed one document's words in order between start and finish
+    void start(Signature& signature);
+    void addWord(Signature& signature, uint32_t id);
+    void finish(Signature& signature); // Covers documents shorter than a shingle
+    
+    static double similarity(const Signature& a, const Signature& b);
+
+private:
+    size_t shingleWords;
+    uint64_t multipliers[SIZE];
+    uint64_t offsets[SIZE];
+    std::vector<uint32_t> recent; // Last shingleWords IDs, as a ring
+    uint64_t seen = 0;
+    
+    void addShingle(Signature& signature, size_t words);
+};
+
+MinHasher::MinHasher(size_t shingleWords, uint64_t seed)
+    : shingleWords(std::max<size_t>(shingleWords, 1)), recent(this->shingleWords) {
+    // splitmix64 stream for the hash parameters
+    for (size_t i = 0; i < SIZE; i++) {
+        seed += 0x9E3779B97F4A7C15ull;
+        multipliers[i] = mixKey(seed) | 1;
+        seed += 0x9E3779B97F4A7C15ull;
+        offsets[i] = mixKey(seed);
+    }
 }
 
-bool TextAnalyzer::isVowel(char c) {
-    char lower = std::tolower(c);
-    return (lower == 'a' || lower == 'e' || lower == 'i' || lower == 'o' || lower == 'u');
+void MinHasher::start(Signature& signature) {
+    signature.fill(UINT32_MAX);
+    seen = 0;
 }
 
-// Process the loaded text
-void TextAnalyzer::processText() {
-    wordFrequency.clear();
-    totalWords = 0;
-    totalSentences = 0;
-    totalSyllables = 0;
+void MinHasher::addWord(Signature& signature, uint32_t id) {
+    recent[seen % shingleWords] = id;
+    if (++seen >= shingleWords) addShingle(signature, shingleWords);
+}
+
+void MinHasher::finish(Signature& signature) {
+    if (seen > 0 && seen < shingleWords) addShingle(signature, static_cast<size_t>(seen));
+}
+
+// Hash the last `words` IDs, oldest first
+void MinHasher::addShingle(Signature& signature, size_t words) {
+    uint64_t key = 0;
+    for (size_t j = 0; j < words; j++) {
+        key = mixKey(key ^ (recent[(seen - words + j) % shingleWords] + 1ull));
+    }
+    key = mixKey(key ^ words);
+    for (size_t i = 0; i < SIZE; i++) {
+        uint32_t value = static_cast<uint32_t>((key * multipliers[i] + offsets[i]) >> 32);
+        signature[i] = std::min(signature[i], value);
+    }
+}
+
+double MinHasher::similarity(const Signature& a, const Signature& b) {
+    size_t equal = 0;
+    for (size_t i = 0; i < SIZE; i++) equal += a[i] == b[i];
+    return static_cast<double>(equal) / SIZE;
+}
+
+// Many documents counted against one shared vocabulary. Each word is stored
+// once for the whole corpus; a document keeps only a sparse vector of
+// (word ID, count) pairs, and the vocabulary entry's count is the number of
+// documents containing the word. A MinHash signature of every document is
+// taken in the same pass, for finding near-duplicates.
+class Corpus {
+private:
+    struct Document {
+        std::string name;
+        std::vector<std::pair<uint32_t, uint32_t>> terms; // Sorted by word ID
+        uint64_t totalWords = 0;
+        MinHasher::Signature signature;
+    };
+    WordTable vocabulary;
+    std::vector<Document> documents;
+    std::string scratch;
+    std::vector<uint32_t> termCounts; // Per word ID, zero between documents
+    std::vector<uint32_t> touched;
+    MinHasher minHasher;
+
+public:
+    struct ScoredTerm {
+        std::string word;
+        double score;
+    };
     
-    std::istringstream iss(text);
-    std::string word;
+    void addDocument(const std::string& name, const char* data, size_t length);
+    bool addFile(const std::string& filename);
+    size_t documentCount() const { return documents.size(); }
+    size_t vocabularySize() const { return vocabulary.size(); }
+    uint64_t documentFrequency(std::string_view word) const;
+    // Words of one document with the highest TF-IDF, tf = count / words in
+    // the document and idf = ln(documents / documents containing the word)
+    std::vector<ScoredTerm> distinguishingTerms(size_t document, size_t count) const;
+    void displayDistinguishingTerms(size_t count) const;
     
-    while (iss >> word) {
-        // Count sentences (simplified - look for .!?)
-        for (char c : word) {
-            if (c == '.' || c == '!' || c == '?') {
-                totalSentences++;
-            }
-        }
-        
-        std::string cleanedWord = cleanWord(word);
-        if (!cleanedWord.empty()) {
-            wordFrequency[cleanedWord]++;
-            totalWords++;
-            totalSyllables += countSyllables(cleanedWord);
+    // Estimated Jaccard similarity of two documents' word shingles
+    double similarity(size_t a, size_t b) const;
+    // Groups of two or more documents that look like copies of each other.
+    // Signatures are split into bands and documents sharing a band are
+    // compared, so the cost is O(n log n) rather than all pairs.
+    std::vector<std::vector<size_t>> nearDuplicates(double threshold = 0.8) const;
+    void displayNearDuplicates(double threshold) const;
+};
+
+void Corpus::addDocument(const std::string& name, const char* data, size_t length) {
+    Document document;
+    document.name = name;
+    minHasher.start(document.signature);
+    forEachWord(data, length, scratch, [this, &document](std::string_view word) {
+        WordTable::Entry& entry = vocabulary.entry(word);
+        minHasher.addWord(document.signature, entry.id);
+        if (entry.id >= termCounts.size()) termCounts.resize(static_cast<size_t>(entry.id) + 1);
+        if (termCounts[entry.id]++ == 0) {
+            touched.push_back(entry.id);
+            entry.count++; // First time in this document
         }
-    }
+        document.totalWords++;
+    });
+    minHasher.finish(document.signature);
     
-    if (totalSentences == 0) totalSentences = 1; // Avoid division by zero
+    std::sort(touched.begin(), touched.end());
+    document.terms.reserve(touched.size());
+    for (uint32_t id : touched) {
+        document.terms.emplace_back(id, termCounts[id]);
+        termCounts[id] = 0;
+    }
+    touched.clear();
+    documents.push_back(std::move(document));
 }
 
-// Display basic statistics
-void TextAnalyzer::displayBasicStats() {
-    std::cout << "\n=== TEXT ANALYSIS RESULTS ===\n";
-    std::cout << "Total Words: " << totalWords << std::endl;
-    std::cout << "Total Sentences: " << totalSentences << std::endl;
-    std::cout << "Total Syllables: " << totalSyllables << std::endl;
-    std::cout << "Unique Words: " << wordFrequency.size() << std::endl;
-    std::cout << "Average Words per Sentence: " << std::fixed << std::setprecision(2) 
-              << (double)totalWords / totalSentences << std::endl;
-    std::cout << "Average Syllables per Word: " << std::fixed << std::setprecision(2)
-              << (double)totalSyllables / totalWords << std::endl;
+bool Corpus::addFile(const std::string& filename) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    addDocument(filename, file.data(), file.size());
+    return true;
 }
 
-// Calculate Flesch-Kincaid Reading Level
-double TextAnalyzer::calculateReadingLevel() {
-    if (totalWords == 0 || totalSentences == 0) return 0.0;
+uint64_t Corpus::documentFrequency(std::string_view word) const {
+    const WordTable::Entry* entry = vocabulary.find(word);
+    return entry ? entry->count : 0;
+}
+
+std::vector<Corpus::ScoredTerm> Corpus::distinguishingTerms(size_t document, size_t count) const {
+    std::vector<ScoredTerm> scored;
+    if (document >= documents.size()) return scored;
+    const Document& doc = documents[document];
+    double total = static_cast<double>(documents.size());
     
-    double avgWordsPerSentence = (double)totalWords / totalSentences;
-    double avgSyllablesPerWord = (double)totalSyllables / totalWords;
+    scored.reserve(doc.terms.size());
+    for (const auto& [id, termCount] : doc.terms) {
+        std::string_view word = vocabulary.wordById(id);
+        double tf = static_cast<double>(termCount) / doc.totalWords;
+        double idf = std::log(total / vocabulary.find(word)->count);
+        scored.push_back({std::string(word), tf * idf});
+    }
     
-    // Flesch-Kincaid Grade Level formula
-    double readingLevel = 0.39 * avgWordsPerSentence + 11.8 * avgSyllablesPerWord - 15.59;
+    // Highest score first, ties alphabetical
+    auto better = [](const ScoredTerm& a, const ScoredTerm& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.word < b.word;
+    };
+    count = std::min(count, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), better);
+    scored.resize(count);
+    return scored;
+}
+
+void Corpus::displayDistinguishingTerms(size_t count) const {
+    std::cout << "\n=== CORPUS ===\n";
+    std::cout << "Documents: " << documents.size() << "\n";
+    std::cout << "Vocabulary: " << vocabulary.size() << " words\n";
     
-    std::cout << "Reading Level (Flesch-Kincaid): " << std::fixed << std::setprecision(1) 
-              << readingLevel << " (Grade " << (int)readingLevel << ")" << std::endl;
+    for (size_t i = 0; i < documents.size(); i++) {
+        std::cout << "\n" << documents[i].name << " (" << documents[i].totalWords << " words)\n";
+        for (const auto& term : distinguishingTerms(i, count)) {
+            std::cout << "  " << std::setw(15) << std::left << term.word
+                      << std::fixed << std::setprecision(5) << term.score << "\n";
+        }
+    }
+}
+
+double Corpus::similarity(size_t a, size_t b) const {
+    // A document without words has no shingles; its untouched signature
+    // would match every other empty one
+    if (documents[a].totalWords == 0 || documents[b].totalWords == 0) return 0.0;
+    return MinHasher::similarity(documents[a].signature, documents[b].signature);
+}
+
+std::vector<std::vector<size_t>> Corpus::nearDuplicates(double threshold) const {
+    // Eight bands of eight slots: documents at similarity s share a band with
+    // probability 1 - (1 - s^8)^8, about 0.9 at s = 0.8 and 0.03 at s = 0.5
+    const size_t bands = 8;
+    const size_t rows = MinHasher::SIZE / bands;
     
-    return readingLevel;
+    std::vector<size_t> parent(documents.size());
+    for (size_t i = 0; i < parent.size(); i++) parent[i] = i;
+    auto root = [&parent](size_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    
+    // Sorting (band key, document) pairs puts each bucket in one run. Each
+    // member is checked against one document of every group already found in
+    // the run, and starts a new group if it matches none, so a chance
+    // collision at the head of a bucket does not hide the real pairs behind
+    // it. Buckets hold few unrelated groups, so this stays near linear.
+    // Documents without words are left out.
+    std::vector<std::pair<uint64_t, size_t>> keys;
+    keys.reserve(documents.size());
+    std::vector<size_t> leaders;
+    for (size_t band = 0; band < bands; band++) {
+        keys.clear();
+        for (size_t i = 0; i < documents.size(); i++) {
+            if (documents[i].totalWords == 0) continue;
+            uint64_t key = band;
+            for (size_t r = 0; r < rows; r++) key = mixKey(key ^ documents[i].signature[band * rows + r]);
+            keys.emplace_back(key, i);
+        }
+        std::sort(keys.begin(), keys.end());
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (i == 0 || keys[i].first != keys[i - 1].first) leaders.clear();
+            size_t document = keys[i].second;
+            bool joined = false;
+            for (size_t leader : leaders) {
+                if (similarity(leader, document) >= threshold) {
+                    parent[root(document)] = root(leader);
+                    joined = true;
+                    break;
+                }
+            }
+            if (!joined) leaders.push_back(document);
+        }
+    }
+    
+    std::vector<std::vector<size_t>> members(documents.size());
+    for (size_t i = 0; i < documents.size(); i++) members[root(i)].push_back(i);
+    std::vector<std::vector<size_t>> groups;
+    for (auto& group : members) {
+        if (group.size() > 1) groups.push_back(std::move(group));
+    }
+    std::sort(groups.begin(), groups.end());
+    return groups;
 }
 
-// Display word frequency
-void TextAnalyzer::displayWordFrequency(int topN) {
-    // Convert map to vector for sorting
-    std::vector<std::pair<std::string, int>> wordVec(wordFrequency.begin(), wordFrequency.end());
+void Corpus::displayNearDuplicates(double threshold) const {
+    auto groups = nearDuplicates(threshold);
+    std::cout << "\n=== NEAR-DUPLICATES (similarity >= " << std::fixed << std::setprecision(2)
+              << threshold << ") ===\n";
+    if (groups.empty()) std::cout << "None found\n";
+    for (const auto& group : groups) {
+        std::cout << documents[group[0]].name << "\n";
+        for (size_t i = 1; i < group.size(); i++) {
+            std::cout << "  ~ " << documents[group[i]].name << " ("
+                      << similarity(group[0], group[i]) << ")\n";
+        }
+    }
+}
+
+// Corpus mode: print the top TF-IDF terms of every input, without prompts,
+// or with --dups the groups of near-duplicate inputs.
+//   TextAnalyzer --corpus [-k terms] [--dups [threshold]] paths...
+// Inputs are named as in batch mode.
+int runCorpus(int argc, char* argv[]) {
+    size_t count = 10;
+    double threshold = 0.0; // No duplicate search
+    std::vector<std::string> inputs;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-k" && i + 1 < argc) {
+            count = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--dups") {
+            threshold = 0.8;
+            char* end = nullptr;
+            double value = i + 1 < argc ? std::strtod(argv[i + 1], &end) : 0.0;
+            if (end && *end == '\0' && value > 0.0 && value <= 1.0) {
+                threshold = value;
+                i++;
+            }
+        } else {
+            inputs.push_back(arg);
+        }
+    }
     
-    // Sort by frequency (descending)
-    std::sort(wordVec.begin(), wordVec.end(), 
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::vector<std::filesystem::path> files;
+    if (!collectInputs(inputs, files)) return 1;
     
-    std::cout << "\n=== TOP " << topN << " WORD FREQUENCIES ===\n";
-    for (int i = 0; i < std::min(topN, (int)wordVec.size()); i++) {
-        std::cout << std::setw(15) << wordVec[i].first << ": " << wordVec[i].second << std::endl;
+    Corpus corpus;
+    bool ok = true;
+    for (const auto& file : files) {
+        ok = corpus.addFile(file.string()) && ok;
+    }
+    if (threshold > 0.0) {
+        corpus.displayNearDuplicates(threshold);
+    } else {
+        corpus.displayDistinguishingTerms(count);
     }
+    return ok ? 0 : 1;
 }
 
-// Find most common words
-void TextAnalyzer::findMostCommonWords(int count) {
-    std::vector<std::pair<std::string, int>> wordVec(wordFrequency.begin(), wordFrequency.end());
-    std::sort(wordVec.begin(), wordVec.end(), 
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+// Batch mode: analyze many files on a pool of worker threads and write one
+// report per file plus a merged corpus report, without any prompts.
+//   TextAnalyzer --batch [-j threads] [-o outdir] [--approx] [--ngrams] paths...
+// Inputs are expanded by collectInputs. Each report is named after the input's
+// position in the sorted list and its flattened path, e.g.
+// 003_logs_a.txt.report.txt. Returns nonzero if any input failed.
+int runBatch(int argc, char* argv[]) {
+    namespace fs = std::filesystem;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    fs::path outDir = ".";
+    bool approximate = false;
+    bool phrases = false;
+    std::vector<std::string> inputs;
     
-    std::cout << "\n=== " << count << " MOST COMMON WORDS ===\n";
-    for (int i = 0; i < std::min(count, (int)wordVec.size()); i++) {
-        std::cout << (i+1) << ". " << wordVec[i].first << " (" << wordVec[i].second << " times)\n";
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-o" && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (arg == "--approx") {
+            approximate = true;
+        } else if (arg == "--ngrams") {
+            phrases = true;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    
+    std::vector<fs::path> files;
+    if (!collectInputs(inputs, files)) return 1;
+    std::error_code error;
+    fs::create_directories(outDir, error);
+    
+    auto started = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> failed(0);
+    std::mutex consoleMutex;
+    threads = static_cast<unsigned>(std::min<size_t>(threads, files.size()));
+    const int indexWidth = static_cast<int>(std::to_string(files.size() - 1).size());
+    
+    // Each worker merges its files into its own partial corpus
+    std::vector<TextAnalyzer> partials(threads);
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < threads; w++) {
+        if (approximate) partials[w].setApproximateMode(true);
+        partials[w].setNGramCounting(phrases);
+        pool.emplace_back([&, w]() {
+            for (size_t i = next++; i < files.size(); i = next++) {
+                TextAnalyzer analyzer;
+                if (approximate) analyzer.setApproximateMode(true);
+                analyzer.setNGramCounting(phrases);
+                
+                // Flatten the input path into a readable report name. Paths
+                // such as a/b.txt and a_b.txt flatten alike, so the index
+                // keeps names unique and no two workers share a file.
+                std::string name = files[i].relative_path().generic_string();
+                std::replace(name.begin(), name.end(), '/', '_');
+                std::ostringstream index;
+                index << std::setw(indexWidth) << std::setfill('0') << i;
+                fs::path reportPath = outDir / (index.str() + "_" + name + ".report.txt");
+                
+                bool ok = analyzer.loadFromFileMapped(files[i].string());
+                std::ofstream report;
+                if (ok) {
+                    report.open(reportPath);
+                    ok = report.is_open();
+                }
+                if (ok) {
+                    analyzer.writeReport(report);
+                    partials[w].merge(analyzer);
+                } else {
+                    failed++;
+                }
+                
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                std::cout << (ok ? "[OK]   " : "[FAIL] ") << files[i].string() << "\n";
+            }
+        });
+    }
+    for (auto& worker : pool) worker.join();
+    
+    TextAnalyzer corpus;
+    if (approximate) corpus.setApproximateMode(true);
+    corpus.setNGramCounting(phrases);
+    for (const auto& partial : partials) corpus.merge(partial);
+    
+    fs::path corpusPath = outDir / "corpus.report.txt";
+    std::ofstream corpusReport(corpusPath);
+    if (!corpusReport.is_open()) {
+        std::cerr << "Error: Could not create output file " << corpusPath.string() << std::endl;
+        return 1;
     }
+    corpus.writeReport(corpusReport);
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "Analyzed " << files.size() - failed << " of " << files.size() << " files on "
+              << threads << " threads in " << std::fixed << std::setprecision(2) << seconds << "s\n";
+    std::cout << "Corpus report written to " << corpusPath.string() << std::endl;
+    return failed == 0 ? 0 : 1;
 }
 
-// Find least common words
-void TextAnalyzer::findLeastCommonWords(int count) {
-    std::vector<std::pair<std::string, int>> wordVec(wordFrequency.begin(), wordFrequency.end());
-    std::sort(wordVec.begin(), wordVec.end(), 
-              [](const auto& a, const auto& b) { return a.second < b.second; });
+// Reproducible synthetic text. Words come from a fixed random vocabulary,
+// and the word of rank r is drawn with weight 1 / r^exponent (Zipf's law),
+// so a few words dominate and most are rare, as in natural text.
+class ZipfTextGenerator {
+private:
+    std::vector<std::string> vocabulary;
+    std::vector<double> cumulative; // Running total of the rank weights
+    std::mt19937_64 random;
+    size_t sentenceLength;
+    size_t wordsInSentence = 0;
+
+public:
+    ZipfTextGenerator(size_t vocabularySize, size_t sentenceLength, double exponent, uint64_t seed);
     
-    std::cout << "\n=== " << count << " LEAST COMMON WORDS ===\n";
-    for (int i = 0; i < std::min(count, (int)wordVec.size()); i++) {
-        std::cout << (i+1) << ". " << wordVec[i].first << " (" << wordVec[i].second << " times)\n";
+    // Append whole words to out until at least `bytes` more have been added
+    void generate(std::string& out, size_t bytes);
+};
+
+ZipfTextGenerator::ZipfTextGenerator(size_t vocabularySize, size_t sentenceLength, double exponent, uint64_t seed)
+    : random(seed), sentenceLength(std::max<size_t>(sentenceLength, 1)) {
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> length(2, 10);
+    double total = 0.0;
+    vocabularySize = std::max<size_t>(vocabularySize, 1);
+    for (size_t rank = 1; rank <= vocabularySize; rank++) {
+        std::string word(length(random), ' ');
+        for (char& c : word) c = static_cast<char>(letter(random));
+        vocabulary.push_back(std::move(word));
+        total += 1.0 / std::pow(static_cast<double>(rank), exponent);
+        cumulative.push_back(total);
     }
 }
 
-// Export results to file
-void TextAnalyzer::exportResults(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not create output file " << filename << std::endl;
-        return;
+void ZipfTextGenerator::generate(std::string& out, size_t bytes) {
+    std::uniform_real_distribution<double> pick(0.0, cumulative.back());
+    size_t target = out.size() + bytes;
+    while (out.size() < target) {
+        size_t rank = std::upper_bound(cumulative.begin(), cumulative.end(), pick(random)) - cumulative.begin();
+        out += vocabulary[std::min(rank, vocabulary.size() - 1)];
+        if (++wordsInSentence == sentenceLength) {
+            out += ".\n";
+            wordsInSentence = 0;
+        } else {
+            out += ' ';
+        }
+    }
+}
+
+// Parse a size such as 512K, 10M or 2G (binary units); 0 when malformed
+uint64_t parseByteSize(const std::string& text) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value <= 0) return 0;
+    switch (std::toupper(static_cast<unsigned char>(*end))) {
+        case 'K': value *= 1 << 10; break;
+        case 'M': value *= 1 << 20; break;
+        case 'G': value *= 1 << 30; break;
+        case '\0': break;
+        default: return 0;
     }
+    return static_cast<uint64_t>(value);
+}
+
+// Benchmark mode: generate Zipfian text of each size, then time every phase.
+//   TextAnalyzer --bench [--sizes 1M,10M,...] [--vocab words] [--sentence words]
+//                [--zipf exponent] [--seed n] [--top k] [-j threads] [--ngrams]
+//                [--dir tmpdir] [--keep]
+// The same arguments always produce the same text, so runs before and after
+// a change are comparable. The input was just written, so loads are usually
+// served from the page cache.
+int runBench(int argc, char* argv[]) {
+    namespace fs = std::filesystem;
+    std::string sizeList = "1M,10M,100M,1G,10G";
+    size_t vocabularySize = 50000;
+    size_t sentenceLength = 15;
+    double exponent = 1.0;
+    uint64_t seed = 42;
+    size_t topK = 100;
+    unsigned threads = 1;
+    bool phrases = false;
+    bool keep = false;
+    fs::path dir = fs::temp_directory_path();
     
-    file << "TEXT ANALYSIS REPORT\n";
-    file << "===================\n\n";
-    file << "Total Words: " << totalWords << "\n";
-    file << "Total Sentences: " << totalSentences << "\n";
-    file << "Unique Words: " << wordFrequency.size() << "\n";
-    file << "Reading Level: " << calculateReadingLevel() << "\n\n";
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            sizeList = argv[++i];
+        } else if (arg == "--vocab" && hasValue) {
+            vocabularySize = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--sentence" && hasValue) {
+            sentenceLength = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--zipf" && hasValue) {
+            exponent = std::atof(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--top" && hasValue) {
+            topK = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-j" && hasValue) {
+            threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--dir" && hasValue) {
+            dir = argv[++i];
+        } else if (arg == "--ngrams") {
+            phrases = true;
+        } else if (arg == "--keep") {
+            keep = true;
+        } else {
+            std::cerr << "Error: Unknown benchmark option " << arg << std::endl;
+            return 1;
+        }
+    }
+    
+    std::vector<uint64_t> sizes;
+    std::stringstream list(sizeList);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        uint64_t size = parseByteSize(item);
+        if (size == 0) {
+            std::cerr << "Error: Bad size " << item << std::endl;
+            return 1;
+        }
+        sizes.push_back(size);
+    }
     
-    file << "WORD FREQUENCY:\n";
-    std::vector<std::pair<std::string, int>> wordVec(wordFrequency.begin(), wordFrequency.end());
-    std::sort(wordVec.begin(), wordVec.end(), 
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::cout << "Zipf exponent " << exponent << ", " << vocabularySize << " word vocabulary, "
+              << sentenceLength << " words per sentence, seed " << seed << ", "
+              << (threads ? threads : std::thread::hardware_concurrency()) << " thread(s)"
+              << (phrases ? ", n-grams on" : "") << "\n";
     
-    for (const auto& pair : wordVec) {
-        file << pair.first << "," << pair.second << "\n";
+    const double MB = 1 << 20;
+    for (uint64_t size : sizes) {
+        fs::path input = dir / ("textanalyzer_bench_" + std::to_string(size) + ".txt");
+        fs::path report = dir / ("textanalyzer_bench_" + std::to_string(size) + ".report.txt");
+        
+        // Generate the input in chunks so memory stays flat at any size
+        {
+            std::ofstream out(input, std::ios::binary);
+            if (!out.is_open()) {
+                std::cerr << "Error: Could not create output file " << input.string() << std::endl;
+                return 1;
+            }
+            ZipfTextGenerator generator(vocabularySize, sentenceLength, exponent, seed);
+            const size_t chunkBytes = 4 << 20;
+            std::string chunk;
+            for (uint64_t written = 0; written < size; written += chunk.size()) {
+                chunk.clear();
+                generator.generate(chunk, static_cast<size_t>(std::min<uint64_t>(chunkBytes, size - written)));
+                out.write(chunk.data(), chunk.size());
+            }
+            if (!out) {
+                std::cerr << "Error: Failed writing " << input.string() << std::endl;
+                return 1;
+            }
+        }
+        uint64_t bytes = fs::file_size(input);
+        
+        // Load: loadFromFile's read into memory, timed by the analyzer's
+        // stats. It holds the whole file, so it is skipped for inputs larger
+        // than maxHeldBytes.
+        const uint64_t maxHeldBytes = uint64_t(1) << 30;
+        double loadSeconds = -1.0;
+        if (bytes <= maxHeldBytes) {
+            TextAnalyzer loader;
+            loader.setThreadCount(threads);
+            if (!loader.loadFromFile(input.string())) return 1;
+            loadSeconds = loader.stats().load.seconds();
+        }
+        
+        // Tokenize: split and clean words without counting them
+        MappedFile mapping;
+        if (!mapping.open(input.string())) {
+            std::cerr << "Error: Could not map file " << input.string() << std::endl;
+            return 1;
+        }
+        uint64_t tokens = 0;
+        std::string scratch;
+        auto started = std::chrono::steady_clock::now();
+        forEachWindow(mapping.data(), 0, mapping.size(), 64 << 20, [&](size_t offset, size_t length) {
+            forEachWord(mapping.data() + offset, length, scratch, [&tokens](std::string_view) { tokens++; });
+        });
+        double tokenizeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        mapping.close();
+        
+        // Map, count, top-K and export through the analyzer, timed by its own
+        // stats. Mapped pages are read in while counting, so most of the
+        // mapped load's I/O shows up under Count.
+        TextAnalyzer analyzer;
+        analyzer.setThreadCount(threads);
+        analyzer.setNGramCounting(phrases);
+        if (!analyzer.loadFromFileMapped(input.string())) return 1;
+        double mapSeconds = analyzer.stats().load.seconds();
+        double countSeconds = analyzer.stats().process.seconds();
+        analyzer.mostCommonWords(topK);
+        double topSeconds = analyzer.stats().report.seconds();
+        std::ofstream out(report);
+        analyzer.writeReport(out);
+        out.close();
+        const PhaseStats& output = analyzer.stats().output;
+        
+        std::cout << "\n=== " << std::fixed << std::setprecision(1) << bytes / MB << " MB, "
+                  << tokens << " tokens ===\n";
+        // A zero rate is left out, as it does not apply to that phase
+        auto row = [&](const char* phase, double seconds, double mbPerSecond, double tokensPerSecond) {
+            std::cout << std::setw(10) << std::left << phase << std::right << std::setprecision(3)
+                      << std::setw(10) << seconds * 1000 << " ms" << std::setprecision(1);
+            if (mbPerSecond > 0) {
+                std::cout << std::setw(10) << mbPerSecond << " MB/s";
+            } else if (tokensPerSecond > 0) {
+                std::cout << std::setw(15) << "";
+            }
+            if (tokensPerSecond > 0) {
+                std::cout << std::setw(14) << std::setprecision(0) << tokensPerSecond << " tokens/s";
+            }
+            std::cout << "\n";
+        };
+        auto rate = [](double amount, double seconds) { return seconds > 0 ? amount / seconds : 0.0; };
+        if (loadSeconds >= 0) {
+            row("Load", loadSeconds, rate(bytes / MB, loadSeconds), 0.0);
+        } else {
+            std::cout << std::setw(10) << std::left << "Load" << std::right << "  skipped, larger than "
+                      << maxHeldBytes / MB << " MB\n";
+        }
+        row("Map", mapSeconds, 0.0, 0.0);
+        row("Tokenize", tokenizeSeconds, rate(bytes / MB, tokenizeSeconds), rate(tokens, tokenizeSeconds));
+        row("Count", countSeconds, rate(bytes / MB, countSeconds), rate(tokens, countSeconds));
+        row("Top-K", topSeconds, 0.0, 0.0); // Works on the vocabulary, not the input
+        row("Export", output.seconds(), rate(output.bytes / MB, output.seconds()), 0.0); // MB written
+        
+        if (!keep) {
+            std::error_code error;
+            fs::remove(input, error);
+            fs::remove(report, error);
+        }
+    }
+    return 0;
+}
+
+// Timeline mode: rolling reading level of stdin as CSV, written as it is read
+//   tail -f log | TextAnalyzer --timeline [-w window] [-s step] [--sentences]
+int runTimeline(int argc, char* argv[]) {
+    size_t window = 1000;
+    size_t step = 0; // Default: a tenth of the window
+    bool bySentences = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-w" && i + 1 < argc) {
+            window = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-s" && i + 1 < argc) {
+            step = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--sentences") {
+            bySentences = true;
+        } else {
+            std::cerr << "Error: Unknown timeline option " << arg << std::endl;
+            return 1;
+        }
     }
     
-    file.close();
-    std::cout << "Results exported to " << filename << std::endl;
+    ReadabilityTimeline timeline(window, bySentences, step ? step : std::max<size_t>(1, window / 10));
+    auto print = [&timeline]() {
+        for (const auto& point : timeline.takePoints()) {
+            std::cout << point.word << "," << point.sentence << "," << std::fixed
+                      << std::setprecision(2) << point.grade << "\n";
+        }
+        std::cout.flush();
+    };
+    
+    std::cout << "word,sentence,grade\n";
+    std::vector<char> chunk(1 << 16);
+    size_t bytes;
+    while ((bytes = std::fread(chunk.data(), 1, chunk.size(), stdin)) > 0) {
+        timeline.feed(chunk.data(), bytes);
+        print();
+    }
+    timeline.finish();
+    print();
+    return std::ferror(stdin) ? 1 : 0;
 }
 
 // Main function with menu system
-int main() {
+int main(int argc, char* argv[]) {
     TextAnalyzer analyzer;
+    analyzer.setThreadCount(0); // Count large inputs on every core
     std::string filename;
     int choice;
     
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--corpus") {
+        return runCorpus(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return runBench(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--timeline") {
+        return runTimeline(argc, argv);
+    }
+    
+    // Non-interactive streaming mode, e.g.
+    //   zcat logs.gz | TextAnalyzer --stream [--approx] [--ngrams] [--stats stats.json] [report.txt]
+    // Phrase counting keeps every distinct bigram and trigram, so it is off
+    // unless asked for.
+    if (argc > 1 && std::string(argv[1]) == "--stream") {
+        int arg = 2;
+        std::string statsFile;
+        for (; arg < argc; arg++) {
+            std::string option = argv[arg];
+            if (option == "--approx") {
+                analyzer.setApproximateMode(true);
+            } else if (option == "--ngrams") {
+                analyzer.setNGramCounting(true);
+            } else if (option == "--stats" && arg + 1 < argc) {
+                statsFile = argv[++arg];
+            } else {
+                break;
+            }
+        }
+        if (!analyzer.loadFromStream(stdin)) {
+            return 1;
+        }
+        analyzer.displayBasicStats();
+        analyzer.calculateReadingLevel();
+        analyzer.displayWordFrequency(10);
+        if (arg < argc) {
+            analyzer.exportResults(argv[arg]);
+        }
+        if (!statsFile.empty()) {
+            std::ofstream stats(statsFile);
+            if (!stats.is_open()) {
+                std::cerr << "Error: Could not create output file " << statsFile << std::endl;
+                return 1;
+            }
+            analyzer.writeStats(stats);
+        }
+        return 0;
+    }
+    
+    // Interactive mode: TextAnalyzer [--ngrams]
+    if (argc > 1 && std::string(argv[1]) == "--ngrams") {
+        analyzer.setNGramCounting(true);
+    }
+    
     std::cout << "=== TEXT ANALYZER ===\n";
     std::cout << "1. Load text from file\n";
     std::cout << "2. Enter text manually\n";
+    std::cout << "3. Load large text file (memory-mapped)\n";
+    std::cout << "4. Open saved analysis snapshot\n";
     std::cout << "Choice: ";
     std::cin >> choice;
     std::cin.ignore(); // Clear the newline
@@ -263,6 +3584,18 @@ int main() {
             text += line + " ";
         }
         analyzer.loadFromString(text);
+    } else if (choice == 3) {
+        std::cout << "Enter filename: ";
+        std::getline(std::cin, filename);
+        if (!analyzer.loadFromFileMapped(filename)) {
+            return 1;
+        }
+    } else if (choice == 4) {
+        std::cout << "Enter snapshot filename: ";
+        std::getline(std::cin, filename);
+        if (!analyzer.loadSnapshot(filename)) {
+            return 1;
+        }
     } else {
         std::cout << "Invalid choice!\n";
         return 1;
@@ -277,7 +3610,14 @@ int main() {
         std::cout << "4. Least Common Words\n";
         std::cout << "5. Reading Level\n";
         std::cout << "6. Export Results\n";
-        std::cout << "7. Exit\n";
+        std::cout << "7. Append Text From File\n";
+        std::cout << "8. Save Binary Snapshot\n";
+        std::cout << "9. Most Common Phrases\n";
+        std::cout << "10. Find Phrase\n";
+        std::cout << "11. Filter Stop Words\n";
+        std::cout << "12. Performance Stats\n";
+        std::cout << "13. Readability Timeline\n";
+        std::cout << "14. Exit\n";
         std::cout << "Choice: ";
         
         std::cin >> choice;
@@ -304,6 +3644,53 @@ int main() {
                 analyzer.exportResults(filename);
                 break;
             case 7:
+                std::cout << "Enter filename: ";
+                std::cin >> filename;
+                analyzer.appendFile(filename);
+                break;
+            case 8:
+                std::cout << "Enter snapshot filename: ";
+                std::cin >> filename;
+                analyzer.saveSnapshot(filename);
+                break;
+            case 9:
+                analyzer.findMostCommonPhrases(2, 5);
+                analyzer.findMostCommonPhrases(3, 5);
+                break;
+            case 10: {
+                std::cout << "Enter word or phrase: ";
+                std::cin.ignore();
+                std::string phrase;
+                std::getline(std::cin, phrase);
+                analyzer.displayPhraseSearch(phrase);
+                break;
+            }
+            case 11: {
+                std::cout << "Enter stop word list file (blank for built-in list only): ";
+                std::cin.ignore();
+                std::getline(std::cin, filename);
+                if (filename.empty()) {
+                    analyzer.setStopWordFiltering(true);
+                } else if (!analyzer.loadStopWords(filename)) {
+                    break;
+                }
+                std::cout << "Stop words are now left out of word frequencies\n";
+                break;
+            }
+            case 12:
+                analyzer.displayStats();
+                break;
+            case 13: {
+                size_t window;
+                char unit;
+                std::cout << "Window size: ";
+                std::cin >> window;
+                std::cout << "Count (w)ords or (s)entences: ";
+                std::cin >> unit;
+                analyzer.displayReadabilityTimeline(window, unit == 's' || unit == 'S');
+                break;
+            }
+            case 14:
                 std::cout << "Thank you for using Text Analyzer!\n";
                 return 0;
             default:
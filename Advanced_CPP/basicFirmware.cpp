@@ -1,8 +1,13 @@
 #include <iostream>
 #include <cstdint>
+#include <cstddef>
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
 
 // Hardware abstraction layer (HAL) - simulated for demonstration
 namespace HAL {
@@ -75,6 +80,7 @@ struct Task {
     uint32_t lastRunMs;
     TaskPriority priority;
     const char* name;
+    std::chrono::steady_clock::time_point nextRelease;
 };
 
 // System initialization
@@ -153,48 +159,322 @@ void criticalErrorISR() {
     g_systemState.systemRunning = false;
 }
 
-// Simple task scheduler
+// Deadline-driven task scheduler. Tasks wait in a min-heap ordered by their
+// next release time, and the loop sleeps until the earliest one is due
+// instead of polling, so tasks start within the clock's resolution and an
+// idle system stays asleep. Released tasks move to a ready heap ordered by
+// priority, so when several are due the most important runs first, and one
+// released while a LOW task runs goes ahead of any LOW tasks still waiting.
+//
+// By default the tasks run on the scheduler's own thread, in a deterministic
+// order. With setWorkerCount(n > 1) the scheduler thread only keeps time and
+// hands released tasks, highest priority first, to per-worker deques; an idle
+// worker steals from the back of another's deque. A task goes back into the
+// release heap only when its run has finished, so it never overlaps itself.
 class TaskScheduler {
 private:
-    static constexpr size_t MAX_TASKS = 10;
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t MAX_TASKS = 256;
+    static constexpr size_t MAX_WORKERS = 16;
+    static constexpr size_t PRIORITY_LEVELS = 5; // Indexed by TaskPriority value
     Task tasks[MAX_TASKS];
     size_t taskCount = 0;
+    size_t pending[MAX_TASKS]; // Task indices, earliest release on top
+    size_t pendingCount = 0;
+    size_t ready[MAX_TASKS];   // Released task indices, highest priority on top
+    size_t readyCount = 0;
+    Clock::time_point start;
+    Clock::time_point nextWatchdog;
+    static constexpr std::chrono::seconds WATCHDOG_PERIOD{10};
+    
+    // Worst delay from release to start, per priority level
+    Clock::duration worstLatency[PRIORITY_LEVELS] = {};
+    uint32_t runs[PRIORITY_LEVELS] = {};
+    std::mutex statsMutex; // Workers record their runs concurrently
+    
+    std::mutex wakeMutex;
+    std::condition_variable wakeup; // Signalled by stop() and finished runs
+    size_t finished[MAX_TASKS];     // Tasks run by workers, back from their run
+    size_t finishedCount = 0;
+    
+    // Fixed ring of task indices: the owner takes from the front, in the
+    // order the scheduler queued them, and thieves take from the back. Each
+    // task is queued at most once, so MAX_TASKS slots always suffice.
+    struct WorkDeque {
+        std::mutex lock;
+        size_t items[MAX_TASKS];
+        size_t head = 0;
+        size_t count = 0;
+        
+        void pushBack(size_t task) {
+            std::lock_guard<std::mutex> guard(lock);
+            items[(head + count++) % MAX_TASKS] = task;
+        }
+        
+        bool popFront(size_t& task) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (count == 0) return false;
+            task = items[head];
+            head = (head + 1) % MAX_TASKS;
+            count--;
+            return true;
+        }
+        
+        bool popBack(size_t& task) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (count == 0) return false;
+            task = items[(head + --count) % MAX_TASKS];
+            return true;
+        }
+    };
+    
+    size_t workerCount = 1;
+    WorkDeque deques[MAX_WORKERS];
+    std::thread workers[MAX_WORKERS];
+    size_t nextDeque = 0;
+    std::mutex workMutex;
+    std::condition_variable workReady;
+    std::atomic<size_t> queued{0};
+    
+    bool releasedFirst(size_t a, size_t b) const {
+        return tasks[a].nextRelease < tasks[b].nextRelease;
+    }
+    
+    bool runsFirst(size_t a, size_t b) const {
+        if (tasks[a].priority != tasks[b].priority) return tasks[a].priority > tasks[b].priority;
+        return releasedFirst(a, b);
+    }
+    
+    // Binary heap of task indices in a fixed array; `first(a, b)` is true
+    // when task a belongs nearer the top
+    template <typename First>
+    static void heapPush(size_t* heap, size_t& count, size_t task, First first) {
+        size_t i = count++;
+        heap[i] = task;
+        while (i > 0 && first(heap[i], heap[(i - 1) / 2])) {
+            std::swap(heap[i], heap[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+    }
+    
+    template <typename First>
+    static size_t heapPop(size_t* heap, size_t& count, First first) {
+        size_t top = heap[0];
+        heap[0] = heap[--count];
+        for (size_t i = 0;;) {
+            size_t child = 2 * i + 1;
+            if (child >= count) break;
+            if (child + 1 < count && first(heap[child + 1], heap[child])) child++;
+            if (!first(heap[child], heap[i])) break;
+            std::swap(heap[i], heap[child]);
+            i = child;
+        }
+        return top;
+    }
+    
+    void pushPending(size_t task) {
+        heapPush(pending, pendingCount, task, [this](size_t a, size_t b) { return releasedFirst(a, b); });
+    }
+    
+    // Move every task whose release time has come to the ready heap
+    void releaseDue(Clock::time_point now) {
+        auto byRelease = [this](size_t a, size_t b) { return releasedFirst(a, b); };
+        auto byPriority = [this](size_t a, size_t b) { return runsFirst(a, b); };
+        while (pendingCount && tasks[pending[0]].nextRelease <= now) {
+            heapPush(ready, readyCount, heapPop(pending, pendingCount, byRelease), byPriority);
+        }
+    }
+    
+    size_t popReady() {
+        return heapPop(ready, readyCount, [this](size_t a, size_t b) { return runsFirst(a, b); });
+    }
+    
+    // Run one released task and move its release to the next period. Returns
+    // the time the run ended.
+    Clock::time_point runTask(Task& task) {
+        Clock::time_point started = Clock::now();
+        size_t level = static_cast<size_t>(task.priority);
+        if (level < PRIORITY_LEVELS) {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            worstLatency[level] = std::max(worstLatency[level], started - task.nextRelease);
+            runs[level]++;
+        }
+        
+        task.function();
+        Clock::time_point now = Clock::now();
+        task.lastRunMs = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count());
+        
+        // Releases stay on the task's own period grid, so they do not
+        // drift; releases already missed by an overrun are skipped
+        auto period = std::chrono::milliseconds(std::max<uint32_t>(task.periodMs, 1));
+        do {
+            task.nextRelease += period;
+        } while (task.nextRelease <= now);
+        return now;
+    }
+    
+    // Own deque first, then steal from the others
+    bool takeWork(size_t self, size_t& task) {
+        if (deques[self].popFront(task)) return true;
+        for (size_t k = 1; k < workerCount; k++) {
+            if (deques[(self + k) % workerCount].popBack(task)) return true;
+        }
+        return false;
+    }
+    
+    void workerLoop(size_t self) {
+        while (true) {
+            size_t task;
+            if (!takeWork(self, task)) {
+                std::unique_lock<std::mutex> lock(workMutex);
+                workReady.wait(lock, [this] { return !g_systemState.systemRunning || queued > 0; });
+                if (!g_systemState.systemRunning) return;
+                continue;
+            }
+            queued--;
+            
+            runTask(tasks[task]);
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                finished[finishedCount++] = task;
+            }
+            wakeup.notify_one();
+        }
+    }
+    
+    // Hand released tasks to the workers, highest priority first
+    void dispatchReady() {
+        size_t handedOut = 0;
+        while (readyCount) {
+            deques[nextDeque].pushBack(popReady());
+            nextDeque = (nextDeque + 1) % workerCount;
+            handedOut++;
+        }
+        if (handedOut) {
+            {
+                std::lock_guard<std::mutex> lock(workMutex);
+                queued += handedOut;
+            }
+            workReady.notify_all();
+        }
+    }
+    
+    // Simulate watchdog timer reset
+    void serviceWatchdog(Clock::time_point now) {
+        if (now >= nextWatchdog) {
+            std::cout << "[WATCHDOG] System alive - resetting watchdog timer\n";
+            nextWatchdog += WATCHDOG_PERIOD;
+        }
+    }
+    
+    static const char* priorityName(size_t level) {
+        static const char* const names[PRIORITY_LEVELS] = {"", "LOW", "MEDIUM", "HIGH", "CRITICAL"};
+        return level < PRIORITY_LEVELS ? names[level] : "?";
+    }
     
 public:
     void addTask(void (*func)(), uint32_t periodMs, TaskPriority priority, const char* name) {
         if (taskCount < MAX_TASKS) {
-            tasks[taskCount] = {func, periodMs, 0, priority, name};
+            tasks[taskCount] = {func, periodMs, 0, priority, name, Clock::time_point()};
             taskCount++;
             std::cout << "[SCHEDULER] Added task: " << name << " (period: " << periodMs << "ms)\n";
         }
     }
     
+    // Run tasks on this many worker threads (0 = one per core). 1, the
+    // default, runs them on the scheduler thread itself. Set before run().
+    void setWorkerCount(unsigned count) {
+        if (count == 0) count = std::thread::hardware_concurrency();
+        workerCount = std::min<size_t>(std::max(count, 1u), MAX_WORKERS);
+    }
+    
+    // Stop the loop now rather than at its next wakeup
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            g_systemState.systemRunning = false;
+        }
+        wakeup.notify_all();
+    }
+    
     void run() {
-        std::cout << "[SCHEDULER] Starting task scheduler with " << taskCount << " tasks\n\n";
+        std::cout << "[SCHEDULER] Starting task scheduler with " << taskCount << " tasks";
+        if (workerCount > 1) std::cout << " on " << workerCount << " workers";
+        std::cout << "\n\n";
+        
+        // Every task is first released at start-up
+        start = Clock::now();
+        pendingCount = readyCount = finishedCount = 0;
+        for (size_t i = 0; i < taskCount; i++) {
+            tasks[i].nextRelease = start;
+            pushPending(i);
+        }
+        if (workerCount > 1) {
+            for (size_t w = 0; w < workerCount; w++) workers[w] = std::thread(&TaskScheduler::workerLoop, this, w);
+        }
+        
+        nextWatchdog = start + WATCHDOG_PERIOD;
         
         while (g_systemState.systemRunning) {
-            auto currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()).count();
-            
-            // Execute tasks based on their schedule
-            for (size_t i = 0; i < taskCount; i++) {
-                if (currentTime - tasks[i].lastRunMs >= tasks[i].periodMs) {
-                    tasks[i].function();
-                    tasks[i].lastRunMs = currentTime;
-                }
+            // Sleep until the earliest release or a worker finishing a run (an
+            // ISR clearing systemRunning is seen then; stop() wakes the loop
+            // at once)
+            Clock::time_point deadline = pendingCount ? tasks[pending[0]].nextRelease : nextWatchdog;
+            deadline = std::min(deadline, nextWatchdog);
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeup.wait_until(lock, deadline, [this] {
+                    return !g_systemState.systemRunning || finishedCount > 0;
+                });
+                for (size_t i = 0; i < finishedCount; i++) pushPending(finished[i]);
+                finishedCount = 0;
             }
+            if (!g_systemState.systemRunning) break;
             
-            // Simulate watchdog timer reset
-            static uint32_t watchdogCounter = 0;
-            if (++watchdogCounter % 1000 == 0) {
-                std::cout << "[WATCHDOG] System alive - resetting watchdog timer\n";
+            Clock::time_point now = Clock::now();
+            releaseDue(now);
+            if (workerCount > 1) {
+                dispatchReady();
+            } else {
+                // Run released tasks one at a time, highest priority first.
+                // Tasks are not preempted, but releases are checked again after
+                // each one, so a long LOW task delays a CRITICAL one at most once.
+                // The run flag and watchdog are checked after every task, so an
+                // overloaded task set cannot keep this loop from stopping.
+                while (g_systemState.systemRunning && readyCount) {
+                    size_t task = popReady();
+                    now = runTask(tasks[task]);
+                    pushPending(task);
+                    releaseDue(now);
+                    serviceWatchdog(now);
+                }
             }
-            
-            // Sleep to prevent 100% CPU usage in simulation
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            serviceWatchdog(now);
         }
         
+        if (workerCount > 1) {
+            // Taking the lock keeps the notify from slipping in between a
+            // worker's predicate check and its wait
+            {
+                std::lock_guard<std::mutex> lock(workMutex);
+            }
+            workReady.notify_all();
+            for (size_t w = 0; w < workerCount; w++) workers[w].join();
+        }
         std::cout << "\n[SCHEDULER] System shutdown initiated\n";
+        printLatencyReport();
+    }
+    
+    void printLatencyReport() {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        std::cout << "[SCHEDULER] Worst-case release latency by priority:\n";
+        for (size_t level = PRIORITY_LEVELS - 1; level > 0; level--) {
+            if (runs[level] == 0) continue;
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(worstLatency[level]).count();
+            std::cout << "[SCHEDULER]   " << priorityName(level) << ": " << micros << " us over "
+                      << runs[level] << " runs\n";
+        }
     }
 };
 
@@ -206,30 +486,227 @@ void enterLowPowerMode() {
 }
 
 // Memory management for embedded systems
+//
+// Buddy allocator over a fixed pool. Blocks come in power-of-two size
+// classes from MIN_BLOCK up to POOL_SIZE, and each class keeps a free list
+// threaded through the free blocks themselves. A bitmap marks the classes
+// that have a free block, so the smallest one that fits is found with one
+// count-trailing-zeros. Splitting and coalescing take at most one step per
+// class, so every call is bounded by log2(POOL_SIZE / MIN_BLOCK) whatever
+// state the pool is in. Requests are rounded up to their class size.
+template <size_t POOL_SIZE = 1024, size_t MIN_BLOCK = 16>
 class MemoryPool {
 private:
-    static constexpr size_t POOL_SIZE = 1024;
-    uint8_t memory[POOL_SIZE];
-    bool allocated[POOL_SIZE];
+    struct FreeBlock {
+        FreeBlock* prev;
+        FreeBlock* next;
+    };
+    
+    static constexpr bool isPowerOfTwo(size_t n) { return n && !(n & (n - 1)); }
+    static constexpr size_t log2Of(size_t n) { return n > 1 ? 1 + log2Of(n / 2) : 0; }
+    
+    static_assert(isPowerOfTwo(POOL_SIZE) && isPowerOfTwo(MIN_BLOCK), "Pool and block sizes must be powers of two");
+    static_assert(MIN_BLOCK >= sizeof(FreeBlock), "A block must hold the free-list links");
+    static_assert(POOL_SIZE >= MIN_BLOCK, "Pool must hold at least one block");
+    
+    static constexpr size_t UNITS = POOL_SIZE / MIN_BLOCK;
+    static constexpr size_t CLASSES = log2Of(UNITS) + 1;
+    static_assert(CLASSES <= 32, "Size classes must fit the class bitmap");
+    
+    // Per MIN_BLOCK unit: 0 unless a block starts there, else its class
+    // tagged FREE or USED
+    static constexpr uint8_t FREE = 0x80;
+    static constexpr uint8_t USED = 0x40;
+    
+    alignas(std::max_align_t) uint8_t memory[POOL_SIZE];
+    uint8_t blockHead[UNITS] = {};
+    FreeBlock* freeLists[CLASSES] = {};
+    uint32_t nonEmpty = 0; // Bit k set while class k has a free block
+    
+    static size_t lowestSetBit(uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctz(bits));
+#else
+        size_t bit = 0;
+        while (!(bits & 1u)) { bits >>= 1; bit++; }
+        return bit;
+#endif
+    }
+    
+    // Smallest class whose blocks hold `size` bytes
+    static size_t classFor(size_t size) {
+        size_t units = (size + MIN_BLOCK - 1) / MIN_BLOCK;
+        if (units <= 1) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+        return 64 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(units - 1)));
+#else
+        size_t k = 0;
+        while ((size_t(1) << k) < units) k++;
+        return k;
+#endif
+    }
+    
+    FreeBlock* blockAt(size_t unit) {
+        return reinterpret_cast<FreeBlock*>(memory + unit * MIN_BLOCK);
+    }
+    
+    void pushFree(size_t unit, size_t k) {
+        FreeBlock* block = blockAt(unit);
+        block->prev = nullptr;
+        block->next = freeLists[k];
+        if (freeLists[k]) freeLists[k]->prev = block;
+        freeLists[k] = block;
+        nonEmpty |= 1u << k;
+        blockHead[unit] = static_cast<uint8_t>(FREE | k);
+    }
+    
+    void removeFree(size_t unit, size_t k) {
+        FreeBlock* block = blockAt(unit);
+        if (block->prev) block->prev->next = block->next;
+        else freeLists[k] = block->next;
+        if (block->next) block->next->prev = block->prev;
+        if (!freeLists[k]) nonEmpty &= ~(1u << k);
+        blockHead[unit] = 0;
+    }
     
 public:
+    MemoryPool() {
+        pushFree(0, CLASSES - 1);
+    }
+    
     void* allocate(size_t size) {
-        for (size_t i = 0; i <= POOL_SIZE - size; i++) {
-            bool canAllocate = true;
-            for (size_t j = 0; j < size; j++) {
-                if (allocated[i + j]) {
-                    canAllocate = false;
-                    break;
-                }
+        size_t k = classFor(size);
+        uint32_t fits = (size == 0 || size > POOL_SIZE) ? 0 : nonEmpty & ~((1u << k) - 1);
+        if (!fits) {
+            std::cout << "[MEMORY] ERROR: Out of memory!\n";
+            return nullptr;
+        }
+        
+        // Take a block from the smallest non-empty class that fits and split
+        // it down, returning the upper halves to their free lists
+        size_t from = lowestSetBit(fits);
+        size_t unit = static_cast<size_t>(reinterpret_cast<uint8_t*>(freeLists[from]) - memory) / MIN_BLOCK;
+        removeFree(unit, from);
+        while (from > k) {
+            from--;
+            pushFree(unit + (size_t(1) << from), from);
+        }
+        blockHead[unit] = static_cast<uint8_t>(USED | k);
+        
+        std::cout << "[MEMORY] Allocated " << size << " bytes at offset " << unit * MIN_BLOCK
+                  << " (" << (MIN_BLOCK << k) << "-byte block)\n";
+        return memory + unit * MIN_BLOCK;
+    }
+    
+    void deallocate(void* ptr, size_t size) {
+        if (ptr >= memory && ptr < memory + POOL_SIZE) {
+            size_t offset = static_cast<uint8_t*>(ptr) - memory;
+            size_t unit = offset / MIN_BLOCK;
+            if (offset % MIN_BLOCK != 0 || !(blockHead[unit] & USED)) {
+                std::cout << "[MEMORY] ERROR: No allocated block at offset " << offset << "\n";
+                return;
             }
             
-            if (canAllocate) {
-                for (size_t j = 0; j < size; j++) {
-                    allocated[i + j] = true;
-                }
-                std::cout << "[MEMORY] Allocated " << size << " bytes at offset " << i << "\n";
-                return &memory[i];
+            // Merge with the buddy for as long as it is free and whole
+            size_t k = blockHead[unit] & ~USED;
+            blockHead[unit] = 0;
+            while (k + 1 < CLASSES) {
+                size_t buddy = unit ^ (size_t(1) << k);
+                if (blockHead[buddy] != (FREE | k)) break;
+                removeFree(buddy, k);
+                unit &= ~(size_t(1) << k);
+                k++;
             }
+            pushFree(unit, k);
+            std::cout << "[MEMORY] Deallocated " << size << " bytes at offset " << offset << "\n";
+        }
+    }
+};
+
+// Bitmap variant of the pool: one bit per BLOCK_SIZE bytes, packed into
+// 64-bit words, so with the default 1-byte blocks the metadata is 8x smaller
+// than a bool per byte. Free runs are found a word at a time with
+// count-trailing-zeros on masked words, skipping whole used or free words
+// at once. Allocations honor a power-of-two alignment of up to MAX_ALIGNMENT
+// bytes; the default is alignof(std::max_align_t), like malloc.
+template <size_t POOL_SIZE = 1024, size_t BLOCK_SIZE = 1>
+class BitmapMemoryPool {
+private:
+    static constexpr bool isPowerOfTwo(size_t n) { return n && !(n & (n - 1)); }
+    
+    static_assert(isPowerOfTwo(BLOCK_SIZE), "Block size must be a power of two");
+    static_assert(POOL_SIZE % BLOCK_SIZE == 0, "Pool must be a whole number of blocks");
+    
+    static constexpr size_t MAX_ALIGNMENT = 64;
+    static constexpr size_t UNITS = POOL_SIZE / BLOCK_SIZE;
+    static constexpr size_t WORDS = (UNITS + 63) / 64;
+    
+    alignas(MAX_ALIGNMENT) uint8_t memory[POOL_SIZE];
+    uint64_t used[WORDS] = {}; // Bit set = block allocated
+    
+    static size_t trailingZeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(bits));
+#else
+        size_t bit = 0;
+        while (!(bits & 1u)) { bits >>= 1; bit++; }
+        return bit;
+#endif
+    }
+    
+    // First block in [from, limit) that is allocated (or free, when
+    // `wantUsed` is false), or limit if there is none
+    size_t findBlock(size_t from, size_t limit, bool wantUsed) const {
+        while (from < limit) {
+            size_t word = from / 64;
+            uint64_t bits = (wantUsed ? used[word] : ~used[word]) & (~uint64_t(0) << (from % 64));
+            if (bits) return std::min(limit, word * 64 + trailingZeros(bits));
+            from = (word + 1) * 64;
+        }
+        return limit;
+    }
+    
+    void markBlocks(size_t first, size_t count, bool allocated) {
+        while (count) {
+            size_t bit = first % 64;
+            size_t take = std::min(count, 64 - bit);
+            uint64_t mask = (take == 64 ? ~uint64_t(0) : (uint64_t(1) << take) - 1) << bit;
+            if (allocated) used[first / 64] |= mask;
+            else used[first / 64] &= ~mask;
+            first += take;
+            count -= take;
+        }
+    }
+    
+public:
+    BitmapMemoryPool() {
+        // Bits past the end of the pool read as allocated, so scans stop there
+        if (UNITS % 64) used[WORDS - 1] = ~uint64_t(0) << (UNITS % 64);
+    }
+    
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        if (size == 0 || size > POOL_SIZE || !isPowerOfTwo(alignment) || alignment > MAX_ALIGNMENT) {
+            std::cout << "[MEMORY] ERROR: Invalid request of " << size << " bytes aligned to " << alignment << "\n";
+            return nullptr;
+        }
+        
+        size_t count = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        size_t step = alignment > BLOCK_SIZE ? alignment / BLOCK_SIZE : 1;
+        size_t first = 0;
+        while (true) {
+            // Next free block, rounded up to the alignment, then check that
+            // the run from there is long enough
+            first = findBlock(first, UNITS, false);
+            first = (first + step - 1) / step * step;
+            if (first + count > UNITS) break;
+            size_t taken = findBlock(first, first + count, true);
+            if (taken == first + count) {
+                markBlocks(first, count, true);
+                std::cout << "[MEMORY] Allocated " << size << " bytes at offset " << first * BLOCK_SIZE
+                          << " (aligned to " << alignment << ")\n";
+                return memory + first * BLOCK_SIZE;
+            }
+            first = taken + 1;
         }
         
         std::cout << "[MEMORY] ERROR: Out of memory!\n";
@@ -239,19 +716,19 @@ public:
     void deallocate(void* ptr, size_t size) {
         if (ptr >= memory && ptr < memory + POOL_SIZE) {
             size_t offset = static_cast<uint8_t*>(ptr) - memory;
-            for (size_t i = 0; i < size; i++) {
-                allocated[offset + i] = false;
-            }
+            size_t count = std::min((size + BLOCK_SIZE - 1) / BLOCK_SIZE, UNITS - offset / BLOCK_SIZE);
+            markBlocks(offset / BLOCK_SIZE, count, false);
             std::cout << "[MEMORY] Deallocated " << size << " bytes at offset " << offset << "\n";
         }
     }
 };
 
-// Global memory pool
-MemoryPool g_memoryPool;
+// Global memory pools
+MemoryPool<> g_memoryPool;
+BitmapMemoryPool<> g_bitmapPool;
 
 // Main firmware application
-int main() {
+int main(int argc, char* argv[]) {
     // System initialization
     systemInit();
     
@@ -264,10 +741,18 @@ int main() {
     scheduler.addTask(buttonHandlerTask, 50, TaskPriority::HIGH, "BUTTON_HANDLER");
     scheduler.addTask(systemMonitorTask, 500, TaskPriority::LOW, "SYSTEM_MONITOR");
     
+    // Optionally spread tasks over worker threads: --workers N (0 = one per core)
+    if (argc > 2 && std::strcmp(argv[1], "--workers") == 0) {
+        scheduler.setWorkerCount(static_cast<unsigned>(std::atoi(argv[2])));
+    }
+    
     // Demonstrate memory allocation
     void* buffer1 = g_memoryPool.allocate(64);
     void* buffer2 = g_memoryPool.allocate(128);
     
+    // Aligned buffer from the bitmap pool, as for a DMA descriptor ring
+    void* dmaBuffer = g_bitmapPool.allocate(48, 32);
+    
     std::cout << "\n[SYSTEM] Starting main firmware loop...\n";
     std::cout << "[SYSTEM] Press Ctrl+C to simulate system shutdown\n\n";
     
@@ -281,7 +766,7 @@ int main() {
     
     // Simulate shutdown
     std::cout << "\n[SYSTEM] Shutdown signal received\n";
-    g_systemState.systemRunning = false;
+    scheduler.stop();
     
     // Wait for main loop to finish
     mainLoop.join();
@@ -289,6 +774,7 @@ int main() {
     // Cleanup
     g_memoryPool.deallocate(buffer1, 64);
     g_memoryPool.deallocate(buffer2, 128);
+    g_bitmapPool.deallocate(dmaBuffer, 48);
     
     std::cout << "\n[SYSTEM] Firmware shutdown complete\n";
     std::cout << "=== END OF FIRMWARE EXECUTION ===\n";
@@ -308,6 +794,12 @@ FIRMWARE CONCEPTS DEMONSTRATED:
    - Multiple concurrent tasks
    - Different task priorities
    - Periodic task execution
+   - Min-heap of release times; the loop sleeps until the next deadline
+   - Drift-free releases on each task's period grid
+   - Priority-ordered dispatch of released tasks
+   - Worst-case release latency per priority level
+   - Optional multi-worker mode with per-worker deques and work stealing
+   - A task is never released again while its previous run is in flight
 
 3. Interrupt Handling:
    - Simulated interrupt service routine (ISR)
@@ -315,6 +807,10 @@ FIRMWARE CONCEPTS DEMONSTRATED:
 
 4. Memory Management:
    - Custom memory pool for deterministic allocation
+   - Buddy allocator: power-of-two size classes, per-class free lists, coalescing
+   - Bounded-time allocate/free via a class bitmap and count-trailing-zeros
+   - Bitmap pool: one bit per block, word-at-a-time free-run search
+   - Aligned allocations (no more unaligned addresses from a byte array)
    - Fixed-size memory management (no dynamic allocation)
 
 5. System Monitoring: